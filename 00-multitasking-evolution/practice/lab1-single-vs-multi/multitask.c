@@ -3,13 +3,36 @@
 #include "freertos/task.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
 
 #define LED1_PIN GPIO_NUM_2
 #define LED2_PIN GPIO_NUM_4
 #define BUTTON_PIN GPIO_NUM_0
 
+#define DEBOUNCE_US 50000 // Ignore bounce edges for 50 ms after a press
+
 static const char *TAG = "MULTITASK";
 
+static TaskHandle_t emergency_handle = NULL;
+static volatile int64_t button_edge_us = 0; // First falling edge not yet handled by emergency_task
+static volatile bool button_edge_pending = false; // While set, the ISR leaves button_edge_us alone
+
+// Button-to-LED latency (ISR entry -> both LEDs on), in microseconds
+static struct { uint32_t count; int64_t min, max, total; } latency = { 0, INT64_MAX, 0, 0 };
+
+static void IRAM_ATTR button_isr_handler(void *arg)
+{
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    if (button_edge_pending) {
+        return; // Bounce on top of an edge the task hasn't read yet
+    }
+    button_edge_us = esp_timer_get_time();
+    button_edge_pending = true;
+    vTaskNotifyGiveFromISR(emergency_handle, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
 // Task 1: Sensor Reading
 void sensor_task(void *pvParameters)
 {
@@ -50,19 +73,37 @@ void actuator_task(void *pvParameters)
 }
 
 // Task 4: Emergency Response (High Priority)
+// Sleeps until the button ISR notifies it, so there is no polling interval to wait out
 void emergency_task(void *pvParameters)
 {
+    int64_t last_press_us = -DEBOUNCE_US;
     while (1) {
-        if (gpio_get_level(BUTTON_PIN) == 0) {
-            ESP_LOGW(TAG, "EMERGENCY! Button pressed - Immediate response!");
-            // Immediate response because this task has high priority
-            gpio_set_level(LED1_PIN, 1);
-            gpio_set_level(LED2_PIN, 1);
-            vTaskDelay(pdMS_TO_TICKS(100));
-            gpio_set_level(LED1_PIN, 0);
-            gpio_set_level(LED2_PIN, 0);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        int64_t edge_us = button_edge_us;
+        button_edge_pending = false;
+        if (edge_us - last_press_us < DEBOUNCE_US) {
+            continue; // Contact bounce
         }
-        vTaskDelay(pdMS_TO_TICKS(10)); // Check every 10ms
+        if (gpio_get_level(BUTTON_PIN) != 0) {
+            continue; // Release bounce of a press held longer than DEBOUNCE_US
+        }
+        last_press_us = edge_us;
+
+        // Immediate response because this task has high priority
+        gpio_set_level(LED1_PIN, 1);
+        gpio_set_level(LED2_PIN, 1);
+        int64_t response_us = esp_timer_get_time() - edge_us;
+
+        latency.count++;
+        latency.total += response_us;
+        if (response_us < latency.min) latency.min = response_us;
+        if (response_us > latency.max) latency.max = response_us;
+        ESP_LOGW(TAG, "EMERGENCY! Button pressed - LEDs on after %lld us (min %lld / avg %lld / max %lld us, %lu presses)",
+                 response_us, latency.min, latency.total / latency.count, latency.max, latency.count);
+
+        vTaskDelay(pdMS_TO_TICKS(100));
+        gpio_set_level(LED1_PIN, 0);
+        gpio_set_level(LED2_PIN, 0);
     }
 }
 
@@ -80,7 +121,7 @@ void app_main(void)
 
     // Button configuration
     gpio_config_t button_conf = {
-        .intr_type = GPIO_INTR_DISABLE,
+        .intr_type = GPIO_INTR_NEGEDGE, // Button pulls the pin low
         .mode = GPIO_MODE_INPUT,
         .pin_bit_mask = 1ULL << BUTTON_PIN,
         .pull_up_en = 1,
@@ -94,5 +135,9 @@ void app_main(void)
     xTaskCreate(sensor_task, "sensor", 2048, NULL, 2, NULL);
     xTaskCreate(processing_task, "processing", 2048, NULL, 1, NULL);
     xTaskCreate(actuator_task, "actuator", 2048, NULL, 2, NULL);
-    xTaskCreate(emergency_task, "emergency", 2048, NULL, 5, NULL); // Highest priority
+    xTaskCreate(emergency_task, "emergency", 2048, NULL, 5, &emergency_handle); // Highest priority
+
+    // Hook the button ISR only once the task it notifies exists
+    gpio_install_isr_service(0);
+    gpio_isr_handler_add(BUTTON_PIN, button_isr_handler, NULL);
 }
\ No newline at end of file
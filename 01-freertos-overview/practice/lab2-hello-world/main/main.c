@@ -62,8 +62,8 @@ void app_main(void)
     ESP_LOGI(TAG, "=== ESP32 Hello World Demo ===");
     ESP_LOGI(TAG, "ESP-IDF Version: %s", esp_get_idf_version());
     // ESP_LOGI(TAG, "Chip Model: %s", CONFIG_IDF_TARGET); // This is a build-time macro, commenting out for standalone compilation.
-    ESP_LOGI(TAG, "Free Heap: %d bytes", esp_get_free_heap_size());
-    ESP_LOGI(TAG, "Min Free Heap: %d bytes", esp_get_minimum_free_heap_size());
+    ESP_LOGI(TAG, "Free Heap: %lu bytes", (unsigned long)esp_get_free_heap_size());
+    ESP_LOGI(TAG, "Min Free Heap: %lu bytes", (unsigned long)esp_get_minimum_free_heap_size());
     
     // CPU and Flash info
     esp_chip_info_t chip_info;
@@ -74,18 +74,15 @@ void app_main(void)
              (chip_info.features & CHIP_FEATURE_EMB_FLASH) ? "embedded" : "external");
     
     // Demonstrate different logging levels
-    ESP_LOGI(TAG, "
---- Logging Levels Demo ---");
+    ESP_LOGI(TAG, "\n--- Logging Levels Demo ---");
     demonstrate_logging_levels();
     
     // Demonstrate formatted logging
-    ESP_LOGI(TAG, "
---- Formatted Logging Demo ---");
+    ESP_LOGI(TAG, "\n--- Formatted Logging Demo ---");
     demonstrate_formatted_logging();
     
     // Demonstrate conditional logging
-    ESP_LOGI(TAG, "
---- Conditional Logging Demo ---");
+    ESP_LOGI(TAG, "\n--- Conditional Logging Demo ---");
     demonstrate_conditional_logging();
     
     // Main loop with counter
@@ -95,7 +92,7 @@ void app_main(void)
         
         // Log memory status every 10 iterations
         if (counter % 10 == 0) {
-            ESP_LOGI(TAG, "Memory status - Free: %d bytes", esp_get_free_heap_size());
+            ESP_LOGI(TAG, "Memory status - Free: %lu bytes", (unsigned long)esp_get_free_heap_size());
         }
         
         // Simulate different log levels based on counter
@@ -1,9 +1,12 @@
 #include <stdio.h>
-#include <malloc.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "rt_stats.h"
+#include "lab_alloc.h"
 
 #define LED1_PIN GPIO_NUM_2
 #define LED2_PIN GPIO_NUM_4
@@ -58,13 +61,13 @@ void system_info_task(void *pvParameters)
     ESP_LOGI(TAG, "System Info Task started");
     while (1) {
         ESP_LOGI(TAG, "=== System Information ===");
-        ESP_LOGI(TAG, "Free heap: %d bytes", esp_get_free_heap_size());
-        ESP_LOGI(TAG, "Min free heap: %d bytes", esp_get_minimum_free_heap_size());
+        ESP_LOGI(TAG, "Free heap: %lu bytes", (unsigned long)esp_get_free_heap_size());
+        ESP_LOGI(TAG, "Min free heap: %lu bytes", (unsigned long)esp_get_minimum_free_heap_size());
         UBaseType_t task_count = uxTaskGetNumberOfTasks();
         ESP_LOGI(TAG, "Number of tasks: %d", task_count);
         TickType_t uptime = xTaskGetTickCount();
         uint32_t uptime_sec = uptime * portTICK_PERIOD_MS / 1000;
-        ESP_LOGI(TAG, "Uptime: %d seconds", uptime_sec);
+        ESP_LOGI(TAG, "Uptime: %lu seconds", (unsigned long)uptime_sec);
         vTaskDelay(pdMS_TO_TICKS(3000));
     }
 }
@@ -141,32 +144,35 @@ void low_priority_task(void *pvParameters)
 void runtime_stats_task(void *pvParameters)
 {
     ESP_LOGI(TAG, "Runtime Stats Task started");
-    // NOTE: This task requires configGENERATE_RUN_TIME_STATS and configUSE_STATS_FORMATTING_FUNCTIONS
+    // NOTE: This task requires configGENERATE_RUN_TIME_STATS and configUSE_TRACE_FACILITY
     // to be enabled in FreeRTOSConfig.h. The output might be empty otherwise.
-    char *buffer = malloc(2048);
-    if (buffer == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate buffer for runtime stats");
-        vTaskDelete(NULL);
-        return;
-    }
+    static rt_stats_t stats;
+    rt_stats_init(&stats);
+    rt_stats_sample(&stats);
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(10000));
-        ESP_LOGI(TAG, "
-=== Runtime Statistics ===");
-        vTaskGetRunTimeStats(buffer);
-        printf("%s
-", buffer);
-
-        ESP_LOGI(TAG, "
-=== Task List ====");
-        vTaskList(buffer);
-        printf("%s
-", buffer);
+        rt_stats_sample(&stats);
+        ESP_LOGI(TAG, "=== Runtime Statistics (last 10 s) ===");
+        rt_stats_print(&stats, TAG);
     }
-    free(buffer);
 }
 
 
+static int led1_id = 1;
+static char led2_name[] = "FastBlinker";
+static TaskHandle_t task_handles[2];   // LED1, LED2; handed to the task manager
+
+// Created in this order; the LED handles are filled in before TaskManager starts
+static const lab_task_def_t lab_tasks[] = {
+    LAB_TASK(led1_task, "LED1_Task", 2048, &led1_id, 2, &task_handles[0]),
+    LAB_TASK(led2_task, "LED2_Task", 2048, led2_name, 2, &task_handles[1]),
+    LAB_TASK(system_info_task, "SysInfo_Task", 3072, NULL, 1, NULL),
+    LAB_TASK(task_manager, "TaskManager", 2048, task_handles, 3, NULL),
+    LAB_TASK(high_priority_task, "HighPri_Task", 2048, NULL, 4, NULL),
+    LAB_TASK(low_priority_task, "LowPri_Task", 2048, NULL, 1, NULL),
+    LAB_TASK(runtime_stats_task, "RuntimeStats", 4096, NULL, 1, NULL),
+};
+
 void app_main(void)
 {
     ESP_LOGI(TAG, "=== FreeRTOS All-in-One Demo ===");
@@ -180,31 +186,9 @@ void app_main(void)
     };
     gpio_config(&io_conf);
 
-    static int led1_id = 1;
-    static char led2_name[] = "FastBlinker";
-
-    TaskHandle_t led1_handle = NULL;
-    TaskHandle_t led2_handle = NULL;
-
-    // Create basic tasks
-    xTaskCreate(led1_task, "LED1_Task", 2048, &led1_id, 2, &led1_handle);
-    xTaskCreate(led2_task, "LED2_Task", 2048, led2_name, 2, &led2_handle);
-    
-    // Create system info task
-    xTaskCreate(system_info_task, "SysInfo_Task", 3072, NULL, 1, NULL);
-
-    // Create task manager
-    static TaskHandle_t task_handles[2];
-    task_handles[0] = led1_handle;
-    task_handles[1] = led2_handle;
-    xTaskCreate(task_manager, "TaskManager", 2048, task_handles, 3, NULL);
-
-    // Create priority demo tasks
-    xTaskCreate(high_priority_task, "HighPri_Task", 2048, NULL, 4, NULL);
-    xTaskCreate(low_priority_task, "LowPri_Task", 2048, NULL, 1, NULL);
-
-    // Create runtime stats task
-    xTaskCreate(runtime_stats_task, "RuntimeStats", 4096, NULL, 1, NULL);
+    // Basic LED tasks, system info, task manager, priority demo and runtime stats
+    lab_tasks_create(lab_tasks, LAB_ARRAY_SIZE(lab_tasks));
+    lab_alloc_report(TAG);
 
     ESP_LOGI(TAG, "All tasks created. Main task will now idle.");
 }
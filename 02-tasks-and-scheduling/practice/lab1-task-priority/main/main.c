@@ -1,21 +1,36 @@
 #include <stdio.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "rt_stats.h"
+#include "lab_alloc.h"
+#include "sched_trace.h"
 
 #define LED_HIGH_PIN GPIO_NUM_2
 #define LED_MED_PIN GPIO_NUM_4
 #define LED_LOW_PIN GPIO_NUM_5
 #define BUTTON_PIN GPIO_NUM_0
 
+#define PRIORITY_TEST_MS 10000
+#define EQUAL_TASKS 3
+
 static const char *TAG = "PRIORITY_DEMO";
 
+// Record every context switch; the ring keeps the last SCHED_TRACE_EVENTS events.
+// Type 'd' in the monitor to dump at any time, then:
+//   python3 components/sched_trace/sched_trace_decode.py monitor.log -o trace.json
+#define USE_SCHED_TRACE 1
+#define SCHED_TRACE_DUMP_AFTER_TEST 1   // dump the end of each priority test automatically
+enum { MARK_TEST_START = 1, MARK_TEST_END };
+
 // Global variables
 volatile uint32_t high_task_count = 0;
 volatile uint32_t med_task_count = 0;
 volatile uint32_t low_task_count = 0;
+volatile uint32_t equal_task_count[EQUAL_TASKS];
 volatile bool priority_test_running = false;
 volatile bool shared_resource_busy = false;
 
@@ -26,8 +41,7 @@ void high_priority_task(void *pvParameters) {
     ESP_LOGI(TAG, "High Priority Task started (Priority 5)");
     while (1) {
         if (priority_test_running) {
-            high_task_count++;
-            ESP_LOGI(TAG, "HIGH PRIORITY RUNNING (%d)", high_task_count);
+            high_task_count++;   // no logging here: it would dominate the CPU time being measured
             gpio_set_level(LED_HIGH_PIN, 1);
             for (int i = 0; i < 100000; i++) { volatile int dummy = i * 2; }
             gpio_set_level(LED_HIGH_PIN, 0);
@@ -44,7 +58,6 @@ void medium_priority_task(void *pvParameters) {
     while (1) {
         if (priority_test_running) {
             med_task_count++;
-            ESP_LOGI(TAG, "Medium priority running (%d)", med_task_count);
             gpio_set_level(LED_MED_PIN, 1);
             for (int i = 0; i < 200000; i++) { volatile int dummy = i + 100; }
             gpio_set_level(LED_MED_PIN, 0);
@@ -61,7 +74,6 @@ void low_priority_task(void *pvParameters) {
     while (1) {
         if (priority_test_running) {
             low_task_count++;
-            ESP_LOGI(TAG, "Low priority running (%d)", low_task_count);
             gpio_set_level(LED_LOW_PIN, 1);
             for (int i = 0; i < 500000; i++) {
                 volatile int dummy = i - 50;
@@ -80,7 +92,7 @@ void equal_priority_task(void *pvParameters) {
     int task_id = (int)pvParameters;
     while (1) {
         if (priority_test_running) {
-            ESP_LOGI(TAG, "Equal Priority Task %d running", task_id);
+            equal_task_count[task_id - 1]++;
             for (int i = 0; i < 300000; i++) { volatile int dummy = i; }
         }
         vTaskDelay(pdMS_TO_TICKS(50));
@@ -116,36 +128,112 @@ void priority_inversion_low(void *pvParameters) {
 }
 
 // Control Task - starts/stops the test
+// Run time of one task over the test interval, in run-time counter ticks
+static rt_stats_counter_t task_run_time(const rt_stats_t *stats, const char *name) {
+    for (UBaseType_t i = 0; i < stats->count; i++) {
+        if (strcmp(stats->status[i].pcTaskName, name) == 0) return stats->delta[i];
+    }
+    return 0;
+}
+
+// CPU time from the kernel's run-time counters, not from loop iterations
+static void report_cpu_share(const rt_stats_t *stats) {
+    static const struct { const char *name; volatile uint32_t *runs; } rows[] = {
+        { "HighPrio", &high_task_count }, { "MedPrio", &med_task_count }, { "LowPrio", &low_task_count },
+        { "Equal1", &equal_task_count[0] }, { "Equal2", &equal_task_count[1] }, { "Equal3", &equal_task_count[2] },
+    };
+    if (stats->count == 0 || stats->total_delta == 0) {
+        ESP_LOGW(TAG, "Run-time stats unavailable (enable CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS); runs only:");
+        for (size_t i = 0; i < sizeof(rows) / sizeof(rows[0]); i++) ESP_LOGI(TAG, "%-8s runs %lu", rows[i].name, (unsigned long)*rows[i].runs);
+        return;
+    }
+
+    ESP_LOGI(TAG, "Task      CPU ms   CPU%%   runs");
+    for (size_t i = 0; i < sizeof(rows) / sizeof(rows[0]); i++) {
+        rt_stats_counter_t run = task_run_time(stats, rows[i].name);
+        uint64_t cpu_ms = (uint64_t)run * PRIORITY_TEST_MS / stats->total_delta;
+        uint64_t capacity = (uint64_t)stats->total_delta * portNUM_PROCESSORS;
+        ESP_LOGI(TAG, "%-8s %7llu %5.1f%% %6lu", rows[i].name, (unsigned long long)cpu_ms,
+                 100.0 * run / capacity, (unsigned long)*rows[i].runs);
+    }
+
+    // Jain's fairness index over the equal-priority tasks: 1.0 = identical shares, 1/n = one task got everything
+    double sum = 0, sum_sq = 0;
+    for (int i = 0; i < EQUAL_TASKS; i++) {
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "Equal%d", i + 1);
+        double x = (double)task_run_time(stats, name);
+        sum += x;
+        sum_sq += x * x;
+    }
+    if (sum_sq > 0) {
+        ESP_LOGI(TAG, "Round-robin fairness (Jain, Equal1-%d): %.3f (1.000 = perfectly fair, %.3f = worst)",
+                 EQUAL_TASKS, sum * sum / (EQUAL_TASKS * sum_sq), 1.0 / EQUAL_TASKS);
+    }
+}
+
 void control_task(void *pvParameters) {
     ESP_LOGI(TAG, "Control Task started");
+    static rt_stats_t stats;   // ~1 KB; kept off this task's stack
+    rt_stats_init(&stats);
     while (1) {
         if (gpio_get_level(BUTTON_PIN) == 0) {
             if (!priority_test_running) {
-                ESP_LOGW(TAG, "=== STARTING PRIORITY TEST (10 seconds) ===");
+                ESP_LOGW(TAG, "=== STARTING PRIORITY TEST (%d seconds) ===", PRIORITY_TEST_MS / 1000);
                 high_task_count = 0;
                 med_task_count = 0;
                 low_task_count = 0;
+                for (int i = 0; i < EQUAL_TASKS; i++) equal_task_count[i] = 0;
+                rt_stats_sample(&stats);   // baseline
+#if USE_SCHED_TRACE
+                sched_trace_start();
+                sched_trace_mark(MARK_TEST_START);
+#endif
                 priority_test_running = true;
 
-                vTaskDelay(pdMS_TO_TICKS(10000));
+                vTaskDelay(pdMS_TO_TICKS(PRIORITY_TEST_MS));
 
                 priority_test_running = false;
+                rt_stats_sample(&stats);
+#if USE_SCHED_TRACE
+                sched_trace_mark(MARK_TEST_END);
+#endif
                 ESP_LOGW(TAG, "=== PRIORITY TEST RESULTS ===");
-                ESP_LOGI(TAG, "High Priority Task runs: %d", high_task_count);
-                ESP_LOGI(TAG, "Medium Priority Task runs: %d", med_task_count);
-                ESP_LOGI(TAG, "Low Priority Task runs: %d", low_task_count);
-                uint32_t total_runs = high_task_count + med_task_count + low_task_count;
-                if (total_runs > 0) {
-                    ESP_LOGI(TAG, "High priority percentage: %.1f%%", (float)high_task_count / total_runs * 100);
-                    ESP_LOGI(TAG, "Medium priority percentage: %.1f%%", (float)med_task_count / total_runs * 100);
-                    ESP_LOGI(TAG, "Low priority percentage: %.1f%%", (float)low_task_count / total_runs * 100);
-                }
+                report_cpu_share(&stats);
+#if USE_SCHED_TRACE && SCHED_TRACE_DUMP_AFTER_TEST
+                ESP_LOGI(TAG, "Trace: %lu events (%lu overwritten), %lu ns/event", (unsigned long)sched_trace_recorded(),
+                         (unsigned long)sched_trace_overwritten(), (unsigned long)sched_trace_event_ns());
+                sched_trace_dump();
+#endif
             }
         }
+#if USE_SCHED_TRACE
+        sched_trace_poll_console();
+#endif
         vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
 
+static const lab_task_def_t lab_tasks[] = {
+    // Basic Priority Demo
+    LAB_TASK(high_priority_task, "HighPrio", 3072, NULL, 5, NULL),
+    LAB_TASK(medium_priority_task, "MedPrio", 3072, NULL, 3, NULL),
+    LAB_TASK(low_priority_task, "LowPrio", 3072, NULL, 1, NULL),
+
+    // Round-Robin Demo
+    LAB_TASK(equal_priority_task, "Equal1", 2048, 1, 2, NULL),
+    LAB_TASK(equal_priority_task, "Equal2", 2048, 2, 2, NULL),
+    LAB_TASK(equal_priority_task, "Equal3", 2048, 3, 2, NULL),
+
+    // Priority Inversion Demo
+    // Note: This is a simplified demo. Real solutions use mutexes.
+    LAB_TASK(priority_inversion_high, "PI-High", 2048, NULL, 6, NULL), // Highest priority
+    LAB_TASK(priority_inversion_low, "PI-Low", 2048, NULL, 1, NULL),   // Lowest priority
+
+    // Control Task
+    LAB_TASK(control_task, "Control", 3072, NULL, 4, NULL),
+};
+
 void app_main(void) {
     ESP_LOGI(TAG, "=== FreeRTOS Priority Scheduling Demo ===");
 
@@ -165,25 +253,13 @@ void app_main(void) {
     };
     gpio_config(&button_conf);
 
+#if USE_SCHED_TRACE
+    sched_trace_start();   // before the tasks, so their first switches are captured
+#endif
     ESP_LOGI(TAG, "Creating tasks...");
 
-    // Basic Priority Demo
-    xTaskCreate(high_priority_task, "HighPrio", 3072, NULL, 5, NULL);
-    xTaskCreate(medium_priority_task, "MedPrio", 3072, NULL, 3, NULL);
-    xTaskCreate(low_priority_task, "LowPrio", 3072, NULL, 1, NULL);
-
-    // Round-Robin Demo
-    xTaskCreate(equal_priority_task, "Equal1", 2048, (void*)1, 2, NULL);
-    xTaskCreate(equal_priority_task, "Equal2", 2048, (void*)2, 2, NULL);
-    xTaskCreate(equal_priority_task, "Equal3", 2048, (void*)3, 2, NULL);
-
-    // Priority Inversion Demo
-    // Note: This is a simplified demo. Real solutions use mutexes.
-    xTaskCreate(priority_inversion_high, "PI-High", 2048, NULL, 6, NULL); // Highest priority
-    xTaskCreate(priority_inversion_low, "PI-Low", 2048, NULL, 1, NULL);   // Lowest priority
-
-    // Control Task
-    xTaskCreate(control_task, "Control", 3072, NULL, 4, NULL);
+    lab_tasks_create(lab_tasks, LAB_ARRAY_SIZE(lab_tasks));
+    lab_alloc_report(TAG);
 
     ESP_LOGI(TAG, "Press button (GPIO0) to start priority test");
 }
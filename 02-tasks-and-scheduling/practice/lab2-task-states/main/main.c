@@ -1,10 +1,12 @@
 #include <stdio.h>
-#include <malloc.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "rt_stats.h"
+#include "lab_alloc.h"
+#include "sched_trace.h"
 
 #define LED_RUNNING GPIO_NUM_2
 #define LED_READY GPIO_NUM_4
@@ -15,6 +17,11 @@
 
 static const char *TAG = "TASK_STATES";
 
+// Record every context switch / semaphore operation; type 'd' in the monitor to dump the
+// trace, then: python3 components/sched_trace/sched_trace_decode.py monitor.log
+#define USE_SCHED_TRACE 1
+enum { MARK_SUSPEND = 1, MARK_RESUME, MARK_GIVE, MARK_EXT_DELETE };   // sched_trace_mark() values
+
 // Task handles
 TaskHandle_t state_demo_task_handle = NULL;
 TaskHandle_t control_task_handle = NULL;
@@ -104,12 +111,18 @@ void control_task(void *pvParameters) {
             vTaskDelay(pdMS_TO_TICKS(50)); // Debounce
             if (!suspended) {
                 ESP_LOGW(TAG, "=== SUSPENDING State Demo Task ===");
+#if USE_SCHED_TRACE
+                sched_trace_mark(MARK_SUSPEND);
+#endif
                 vTaskSuspend(state_demo_task_handle);
                 gpio_set_level(LED_SUSPENDED, 1);
                 gpio_set_level(LED_RUNNING, 0); gpio_set_level(LED_READY, 0); gpio_set_level(LED_BLOCKED, 0);
                 suspended = true;
             } else {
                 ESP_LOGW(TAG, "=== RESUMING State Demo Task ===");
+#if USE_SCHED_TRACE
+                sched_trace_mark(MARK_RESUME);
+#endif
                 vTaskResume(state_demo_task_handle);
                 gpio_set_level(LED_SUSPENDED, 0);
                 suspended = false;
@@ -120,6 +133,9 @@ void control_task(void *pvParameters) {
         if (gpio_get_level(BUTTON2_PIN) == 0) {
             vTaskDelay(pdMS_TO_TICKS(50)); // Debounce
             ESP_LOGW(TAG, "=== GIVING SEMAPHORE ===");
+#if USE_SCHED_TRACE
+            sched_trace_mark(MARK_GIVE);
+#endif
             xSemaphoreGive(demo_semaphore);
             while (gpio_get_level(BUTTON2_PIN) == 0) vTaskDelay(pdMS_TO_TICKS(10));
         }
@@ -132,10 +148,16 @@ void control_task(void *pvParameters) {
 
         if (control_cycle == 150 && !external_deleted) { // After 15 seconds
             ESP_LOGW(TAG, "Control task deleting external_delete_task");
+#if USE_SCHED_TRACE
+            sched_trace_mark(MARK_EXT_DELETE);
+#endif
             if(external_delete_handle != NULL) vTaskDelete(external_delete_handle);
             external_deleted = true;
         }
 
+#if USE_SCHED_TRACE
+        sched_trace_poll_console();
+#endif
         vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
@@ -143,22 +165,33 @@ void control_task(void *pvParameters) {
 void system_monitor_task(void *pvParameters) {
     ESP_LOGI(TAG, "System Monitor started");
     // NOTE: This task requires configGENERATE_RUN_TIME_STATS and configUSE_TRACE_FACILITY
-    char *buffer = malloc(2048);
-    if (!buffer) {
-        ESP_LOGE(TAG, "Failed to allocate buffer for monitor");
-        vTaskDelete(NULL);
-    }
+    // Binary snapshot into a static table: no malloc, no sprintf with the scheduler suspended
+    static rt_stats_t stats;
+    rt_stats_init(&stats);
+    rt_stats_sample(&stats);
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(5000));
-        ESP_LOGI(TAG, "\n--- SYSTEM MONITOR ---");
-        vTaskList(buffer);
-        printf("Name\t\tState\tPrio\tStack\tNum\n%s\n", buffer);
-        vTaskGetRunTimeStats(buffer);
-        printf("Task\t\tAbs Time\t%%Time\n%s\n", buffer);
+        rt_stats_sample(&stats);
+        ESP_LOGI(TAG, "--- SYSTEM MONITOR (CPU%% over the last 5 s) ---");
+        rt_stats_print(&stats, TAG);
     }
-    free(buffer);
 }
 
+static int self_delete_time = 10;
+
+static const lab_object_def_t lab_objects[] = {
+    LAB_BINARY_SEMAPHORE(&demo_semaphore),
+};
+
+static const lab_task_def_t lab_tasks[] = {
+    LAB_TASK(state_demo_task, "StateDemo", 4096, NULL, 3, &state_demo_task_handle),
+    LAB_TASK(ready_state_demo_task, "ReadyDemo", 2048, NULL, 3, NULL),
+    LAB_TASK(control_task, "Control", 3072, NULL, 4, &control_task_handle),
+    LAB_TASK(system_monitor_task, "Monitor", 4096, NULL, 1, NULL),
+    LAB_TASK(self_deleting_task, "SelfDelete", 2048, &self_delete_time, 2, NULL),
+    LAB_TASK(external_delete_task, "ExtDelete", 2048, NULL, 2, &external_delete_handle),
+};
+
 void app_main(void) {
     ESP_LOGI(TAG, "=== FreeRTOS Task States Demo ===");
 
@@ -167,18 +200,18 @@ void app_main(void) {
     gpio_config_t btn_conf = { .intr_type = GPIO_INTR_DISABLE, .mode = GPIO_MODE_INPUT, .pin_bit_mask = (1ULL << BUTTON1_PIN) | (1ULL << BUTTON2_PIN), .pull_up_en = 1, .pull_down_en = 0 };
     gpio_config(&btn_conf);
 
-    demo_semaphore = xSemaphoreCreateBinary();
+    lab_objects_create(lab_objects, LAB_ARRAY_SIZE(lab_objects));
+#if USE_SCHED_TRACE
+    sched_trace_name(demo_semaphore, "demo_semaphore");
+    sched_trace_start();   // before the tasks, so their first switches are captured
+    ESP_LOGI(TAG, "Scheduler trace on (%lu ns/event); type 'd' to dump", (unsigned long)sched_trace_event_ns());
+#endif
 
     ESP_LOGI(TAG, "LEDs: GPIO2=Run, GPIO4=Ready, GPIO5=Block, GPIO18=Suspend");
     ESP_LOGI(TAG, "Btns: GPIO0=Suspend/Resume, GPIO35=Give Semaphore");
 
-    static int self_delete_time = 10;
-    xTaskCreate(state_demo_task, "StateDemo", 4096, NULL, 3, &state_demo_task_handle);
-    xTaskCreate(ready_state_demo_task, "ReadyDemo", 2048, NULL, 3, NULL);
-    xTaskCreate(control_task, "Control", 3072, NULL, 4, &control_task_handle);
-    xTaskCreate(system_monitor_task, "Monitor", 4096, NULL, 1, NULL);
-    xTaskCreate(self_deleting_task, "SelfDelete", 2048, &self_delete_time, 2, NULL);
-    xTaskCreate(external_delete_task, "ExtDelete", 2048, NULL, 2, &external_delete_handle);
+    lab_tasks_create(lab_tasks, LAB_ARRAY_SIZE(lab_tasks));
+    lab_alloc_report(TAG);
 
     ESP_LOGI(TAG, "All tasks created.");
 }
@@ -6,6 +6,8 @@
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_system.h"
+#include "stack_registry.h"
+#include "lab_alloc.h"
 
 #define LED_OK GPIO_NUM_2
 #define LED_WARNING GPIO_NUM_4
@@ -14,8 +16,10 @@ static const char *TAG = "STACK_MONITOR";
 
 #define STACK_WARNING_THRESHOLD 512
 #define STACK_CRITICAL_THRESHOLD 256
+#define STACK_SAMPLE_BUDGET_US 200   // High-water-mark scanning allowed per monitor cycle (1 s)
+#define STACK_REPORT_EVERY 10        // Print the right-sizing table every N cycles
 
-// Task handles for monitoring
+// Task handles (the monitor finds tasks through the stack registry)
 TaskHandle_t light_task_handle = NULL;
 TaskHandle_t medium_task_handle = NULL;
 TaskHandle_t heavy_task_handle = NULL;
@@ -24,29 +28,31 @@ TaskHandle_t recursion_task_handle = NULL;
 
 // --- Task Functions from README ---
 
+// Every task (including this one and the system tasks) is in the registry from creation
 void stack_monitor_task(void *pvParameters) {
     ESP_LOGI(TAG, "Stack Monitor Task started");
+    int cycle = 0;
     while (1) {
-        ESP_LOGI(TAG, "\n=== STACK USAGE REPORT ===");
-        TaskHandle_t tasks[] = {light_task_handle, medium_task_handle, heavy_task_handle, optimized_task_handle, recursion_task_handle, xTaskGetCurrentTaskHandle()};
-        const char* task_names[] = {"Light", "Medium", "Heavy", "Optimized", "Recursion", "Monitor"};
+        stack_registry_sample(STACK_SAMPLE_BUDGET_US);
         bool stack_warning = false, stack_critical = false;
 
-        for (int i = 0; i < 6; i++) {
-            if (tasks[i] != NULL) {
-                UBaseType_t stack_remaining = uxTaskGetStackHighWaterMark(tasks[i]);
-                uint32_t stack_bytes = stack_remaining * sizeof(StackType_t);
-                ESP_LOGI(TAG, "%sTask: %d bytes remaining", task_names[i], stack_bytes);
-                if (stack_bytes < STACK_CRITICAL_THRESHOLD) {
-                    ESP_LOGE(TAG, "CRITICAL: %sTask stack very low!", task_names[i]);
-                    stack_critical = true;
-                } else if (stack_bytes < STACK_WARNING_THRESHOLD) {
-                    ESP_LOGW(TAG, "WARNING: %sTask stack low", task_names[i]);
-                    stack_warning = true;
-                }
+        for (int i = 0; i < stack_registry_count(); i++) {
+            stack_reg_report_t r;
+            if (!stack_registry_get(i, &r) || !r.alive || r.samples == 0) continue;
+            if (r.min_free_bytes < STACK_CRITICAL_THRESHOLD) {
+                ESP_LOGE(TAG, "CRITICAL: %s stack very low! (%lu bytes free)", r.name, (unsigned long)r.min_free_bytes);
+                stack_critical = true;
+            } else if (r.min_free_bytes < STACK_WARNING_THRESHOLD) {
+                ESP_LOGW(TAG, "WARNING: %s stack low (%lu bytes free)", r.name, (unsigned long)r.min_free_bytes);
+                stack_warning = true;
             }
         }
 
+        if (++cycle % STACK_REPORT_EVERY == 0) {
+            ESP_LOGI(TAG, "=== STACK USAGE REPORT ===");
+            stack_registry_print(TAG);
+        }
+
         if (stack_critical) {
             for (int i = 0; i < 10; i++) { gpio_set_level(LED_WARNING, 1); vTaskDelay(pdMS_TO_TICKS(50)); gpio_set_level(LED_WARNING, 0); vTaskDelay(pdMS_TO_TICKS(50)); }
         } else if (stack_warning) {
@@ -54,7 +60,7 @@ void stack_monitor_task(void *pvParameters) {
         } else {
             gpio_set_level(LED_OK, 1); gpio_set_level(LED_WARNING, 0);
         }
-        vTaskDelay(pdMS_TO_TICKS(3000));
+        vTaskDelay(pdMS_TO_TICKS(1000));
     }
 }
 
@@ -135,6 +141,17 @@ void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName) {
     esp_restart();
 }
 
+static const lab_task_def_t lab_tasks[] = {
+    LAB_TASK(light_stack_task, "LightTask", 1024, NULL, 2, &light_task_handle),
+    LAB_TASK(medium_stack_task, "MediumTask", 2048, NULL, 2, &medium_task_handle),
+    // This heavy task has the same stack size as medium, but uses more, to trigger warnings
+    LAB_TASK(heavy_stack_task, "HeavyTask", 2048, NULL, 2, &heavy_task_handle),
+    // This optimized task uses the heap and should have a high water mark similar to the light task
+    LAB_TASK(optimized_heavy_task, "OptimizedTask", 2048, NULL, 2, &optimized_task_handle),
+    LAB_TASK(recursion_demo_task, "RecursionDemo", 3072, NULL, 1, &recursion_task_handle),
+    LAB_TASK(stack_monitor_task, "StackMonitor", 4096, NULL, 3, NULL),
+};
+
 void app_main(void) {
     ESP_LOGI(TAG, "=== FreeRTOS Stack Monitoring Demo ===");
 
@@ -144,14 +161,8 @@ void app_main(void) {
     ESP_LOGI(TAG, "LEDs: GPIO2=OK, GPIO4=Warning");
     ESP_LOGI(TAG, "Creating tasks...");
 
-    xTaskCreate(light_stack_task, "LightTask", 1024, NULL, 2, &light_task_handle);
-    xTaskCreate(medium_stack_task, "MediumTask", 2048, NULL, 2, &medium_task_handle);
-    // This heavy task has the same stack size as medium, but uses more, to trigger warnings
-    xTaskCreate(heavy_stack_task, "HeavyTask", 2048, NULL, 2, &heavy_task_handle);
-    // This optimized task uses the heap and should have a high water mark similar to the light task
-    xTaskCreate(optimized_heavy_task, "OptimizedTask", 2048, NULL, 2, &optimized_task_handle);
-    xTaskCreate(recursion_demo_task, "RecursionDemo", 3072, NULL, 1, &recursion_task_handle);
-    xTaskCreate(stack_monitor_task, "StackMonitor", 4096, NULL, 3, NULL);
+    lab_tasks_create(lab_tasks, LAB_ARRAY_SIZE(lab_tasks));
+    lab_alloc_report(TAG);
 
     ESP_LOGI(TAG, "All tasks created.");
 }
@@ -6,13 +6,20 @@
 #include "freertos/queue.h"
 #include "esp_log.h"
 #include "driver/gpio.h"
+#include "esp_timer.h"
+#include "spsc_ring.h"
+#include "lab_alloc.h"
 
 static const char *TAG = "QUEUE_LAB";
 
 #define LED_SENDER GPIO_NUM_2
 #define LED_RECEIVER GPIO_NUM_4
 
-QueueHandle_t xQueue;
+// 1 = lock-free SPSC ring (sender_task -> receiver_task is strictly 1:1)
+// 0 = FreeRTOS queue
+#define USE_SPSC_RING 1
+#define RUN_TRANSPORT_BENCHMARK 1
+#define QUEUE_LENGTH 5
 
 typedef struct {
     int id;
@@ -20,6 +27,21 @@ typedef struct {
     uint32_t timestamp;
 } queue_message_t;
 
+#if USE_SPSC_RING
+static spsc_ring_t xRing;
+static queue_message_t ring_storage[QUEUE_LENGTH];
+#define transport_send(msg, wait)    spsc_ring_send(&xRing, (msg), (wait))
+#define transport_receive(msg, wait) spsc_ring_receive(&xRing, (msg), (wait))
+#define transport_waiting()          spsc_ring_count(&xRing)
+#define transport_spaces()           spsc_ring_spaces(&xRing)
+#else
+QueueHandle_t xQueue;
+#define transport_send(msg, wait)    xQueueSend(xQueue, (msg), (wait))
+#define transport_receive(msg, wait) xQueueReceive(xQueue, (msg), (wait))
+#define transport_waiting()          uxQueueMessagesWaiting(xQueue)
+#define transport_spaces()           uxQueueSpacesAvailable(xQueue)
+#endif
+
 void sender_task(void *pvParameters) {
     queue_message_t message;
     int counter = 0;
@@ -29,9 +51,9 @@ void sender_task(void *pvParameters) {
         snprintf(message.message, sizeof(message.message), "Hello from sender #%d", message.id);
         message.timestamp = xTaskGetTickCount();
 
-        BaseType_t xStatus = xQueueSend(xQueue, &message, pdMS_TO_TICKS(1000));
+        BaseType_t xStatus = transport_send(&message, pdMS_TO_TICKS(1000));
         if (xStatus == pdPASS) {
-            ESP_LOGI(TAG, "Sent: ID=%d, Time=%lu", message.id, message.timestamp);
+            ESP_LOGI(TAG, "Sent: ID=%d, Time=%lu", message.id, (unsigned long)message.timestamp);
             gpio_set_level(LED_SENDER, 1);
             vTaskDelay(pdMS_TO_TICKS(100));
             gpio_set_level(LED_SENDER, 0);
@@ -46,7 +68,7 @@ void receiver_task(void *pvParameters) {
     queue_message_t received_message;
     ESP_LOGI(TAG, "Receiver task started");
     while (1) {
-        BaseType_t xStatus = xQueueReceive(xQueue, &received_message, pdMS_TO_TICKS(5000));
+        BaseType_t xStatus = transport_receive(&received_message, pdMS_TO_TICKS(5000));
         if (xStatus == pdPASS) {
             ESP_LOGI(TAG, "Received: ID=%d, MSG=%s", received_message.id, received_message.message);
             gpio_set_level(LED_RECEIVER, 1);
@@ -64,11 +86,11 @@ void queue_monitor_task(void *pvParameters) {
     UBaseType_t uxSpacesAvailable;
     ESP_LOGI(TAG, "Queue monitor task started");
     while (1) {
-        uxMessagesWaiting = uxQueueMessagesWaiting(xQueue);
-        uxSpacesAvailable = uxQueueSpacesAvailable(xQueue);
+        uxMessagesWaiting = transport_waiting();
+        uxSpacesAvailable = transport_spaces();
         ESP_LOGI(TAG, "Queue Status - Messages: %d, Free spaces: %d", uxMessagesWaiting, uxSpacesAvailable);
         printf("Queue: [\n");
-        for (int i = 0; i < 5; i++) {
+        for (int i = 0; i < QUEUE_LENGTH; i++) {
             if (i < uxMessagesWaiting) printf("■");
             else printf("□");
         }
@@ -77,6 +99,96 @@ void queue_monitor_task(void *pvParameters) {
     }
 }
 
+#if RUN_TRANSPORT_BENCHMARK
+// Sender (prio 4) streams timestamped messages to a higher-priority receiver (prio 5),
+// so every message is a real cross-task hand-off. Runs once per transport at boot.
+#define BENCH_MESSAGES 5000
+
+typedef struct { uint32_t seq; int64_t sent_us; } bench_msg_t;
+
+typedef struct {
+    const char *name;
+    BaseType_t (*send)(void *ctx, const bench_msg_t *msg);
+    BaseType_t (*receive)(void *ctx, bench_msg_t *msg);
+    void *ctx;
+    TaskHandle_t notify_done;
+    int64_t latency_sum_us, latency_max_us;
+    int64_t start_us, end_us;
+} bench_t;
+
+static BaseType_t bench_queue_send(void *ctx, const bench_msg_t *msg) { return xQueueSend((QueueHandle_t)ctx, msg, portMAX_DELAY); }
+static BaseType_t bench_queue_receive(void *ctx, bench_msg_t *msg) { return xQueueReceive((QueueHandle_t)ctx, msg, portMAX_DELAY); }
+static BaseType_t bench_ring_send(void *ctx, const bench_msg_t *msg) { return spsc_ring_send((spsc_ring_t *)ctx, msg, portMAX_DELAY); }
+static BaseType_t bench_ring_receive(void *ctx, bench_msg_t *msg) { return spsc_ring_receive((spsc_ring_t *)ctx, msg, portMAX_DELAY); }
+
+static void bench_sender_task(void *p) {
+    bench_t *b = (bench_t *)p;
+    bench_msg_t msg;
+    b->start_us = esp_timer_get_time();
+    for (uint32_t i = 0; i < BENCH_MESSAGES; i++) {
+        msg.seq = i;
+        msg.sent_us = esp_timer_get_time();
+        b->send(b->ctx, &msg);
+    }
+    vTaskDelete(NULL);
+}
+
+static void bench_receiver_task(void *p) {
+    bench_t *b = (bench_t *)p;
+    bench_msg_t msg;
+    for (uint32_t i = 0; i < BENCH_MESSAGES; i++) {
+        b->receive(b->ctx, &msg);
+        int64_t latency = esp_timer_get_time() - msg.sent_us;
+        b->latency_sum_us += latency;
+        if (latency > b->latency_max_us) b->latency_max_us = latency;
+    }
+    b->end_us = esp_timer_get_time();
+    xTaskNotifyGive(b->notify_done);
+    vTaskDelete(NULL);
+}
+
+static void run_bench(bench_t *b) {
+    b->notify_done = xTaskGetCurrentTaskHandle();
+    // Receiver first so it is already blocked when the first message arrives
+    xTaskCreate(bench_receiver_task, "BenchRx", 2048, b, 5, NULL);
+    xTaskCreate(bench_sender_task, "BenchTx", 2048, b, 4, NULL);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    int64_t elapsed = b->end_us - b->start_us;
+    ESP_LOGI(TAG, "%-10s: %6.0f msg/s | latency avg %.1f us, max %lld us",
+             b->name, BENCH_MESSAGES * 1e6f / (elapsed ? elapsed : 1),
+             (float)b->latency_sum_us / BENCH_MESSAGES, b->latency_max_us);
+}
+
+static void transport_benchmark(void) {
+    static bench_msg_t bench_ring_storage[QUEUE_LENGTH];
+    static spsc_ring_t bench_ring;
+    QueueHandle_t bench_queue = xQueueCreate(QUEUE_LENGTH, sizeof(bench_msg_t));
+    if (bench_queue == NULL || !spsc_ring_init(&bench_ring, bench_ring_storage, sizeof(bench_msg_t), QUEUE_LENGTH)) {
+        ESP_LOGE(TAG, "Benchmark setup failed");
+        if (bench_queue) vQueueDelete(bench_queue);
+        return;
+    }
+    ESP_LOGI(TAG, "Transport benchmark: %d messages, depth %d", BENCH_MESSAGES, QUEUE_LENGTH);
+    bench_t queue_bench = { .name = "xQueue", .send = bench_queue_send, .receive = bench_queue_receive, .ctx = bench_queue };
+    run_bench(&queue_bench);
+    bench_t ring_bench = { .name = "SPSC ring", .send = bench_ring_send, .receive = bench_ring_receive, .ctx = &bench_ring };
+    run_bench(&ring_bench);
+    vQueueDelete(bench_queue);
+}
+#endif
+
+#if !USE_SPSC_RING
+static const lab_object_def_t lab_objects[] = {
+    LAB_QUEUE(&xQueue, QUEUE_LENGTH, sizeof(queue_message_t)),
+};
+#endif
+
+static const lab_task_def_t lab_tasks[] = {
+    LAB_TASK(sender_task, "Sender", 2048, NULL, 2, NULL),
+    LAB_TASK(receiver_task, "Receiver", 2048, NULL, 1, NULL),
+    LAB_TASK(queue_monitor_task, "Monitor", 2048, NULL, 1, NULL),
+};
+
 void app_main(void) {
     ESP_LOGI(TAG, "Basic Queue Operations Lab Starting...");
 
@@ -86,12 +198,19 @@ void app_main(void) {
     io_conf.intr_type = GPIO_INTR_DISABLE;
     gpio_config(&io_conf);
 
-    xQueue = xQueueCreate(5, sizeof(queue_message_t));
-    if (xQueue != NULL) {
-        ESP_LOGI(TAG, "Queue created successfully (size: 5 messages)");
-        xTaskCreate(sender_task, "Sender", 2048, NULL, 2, NULL);
-        xTaskCreate(receiver_task, "Receiver", 2048, NULL, 1, NULL);
-        xTaskCreate(queue_monitor_task, "Monitor", 2048, NULL, 1, NULL);
+#if RUN_TRANSPORT_BENCHMARK
+    transport_benchmark();
+#endif
+
+#if USE_SPSC_RING
+    if (spsc_ring_init(&xRing, ring_storage, sizeof(queue_message_t), QUEUE_LENGTH)) {
+        ESP_LOGI(TAG, "SPSC ring created successfully (size: %d messages)", QUEUE_LENGTH);
+#else
+    if (lab_objects_create(lab_objects, LAB_ARRAY_SIZE(lab_objects))) {
+        ESP_LOGI(TAG, "Queue created successfully (size: %d messages)", QUEUE_LENGTH);
+#endif
+        lab_tasks_create(lab_tasks, LAB_ARRAY_SIZE(lab_tasks));
+        lab_alloc_report(TAG);
     } else {
         ESP_LOGE(TAG, "Failed to create queue!");
     }
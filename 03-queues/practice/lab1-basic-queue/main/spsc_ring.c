@@ -0,0 +1,119 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "spsc_ring.h"
+
+bool spsc_ring_init(spsc_ring_t *ring, void *storage, size_t item_size, uint32_t capacity) {
+    if (!ring || !storage || item_size == 0 || capacity == 0 || capacity > UINT32_MAX / 2) {
+        return false;
+    }
+    ring->storage = (uint8_t *)storage;
+    ring->item_size = item_size;
+    ring->capacity = capacity;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->producer, NULL);
+    atomic_init(&ring->consumer, NULL);
+    atomic_init(&ring->producer_waiting, false);
+    atomic_init(&ring->consumer_waiting, false);
+    return true;
+}
+
+// Indices run over twice the capacity so a full ring (distance == capacity) can be
+// told apart from an empty one (distance == 0) without a power-of-two size
+static inline uint32_t ring_distance(const spsc_ring_t *ring, uint32_t head, uint32_t tail) {
+    return head >= tail ? head - tail : head + 2 * ring->capacity - tail;
+}
+
+static inline uint32_t ring_next(const spsc_ring_t *ring, uint32_t index) {
+    return index + 1 == 2 * ring->capacity ? 0 : index + 1;
+}
+
+static inline uint8_t *ring_slot(const spsc_ring_t *ring, uint32_t index) {
+    return ring->storage + (index < ring->capacity ? index : index - ring->capacity) * ring->item_size;
+}
+
+// Sleep on our notification until woken or the deadline passes. Returns false on timeout.
+static bool wait_for_peer(atomic_bool *waiting_flag, TickType_t start, TickType_t ticks_to_wait) {
+    TickType_t remaining = portMAX_DELAY;
+    if (ticks_to_wait != portMAX_DELAY) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed >= ticks_to_wait) return false;
+        remaining = ticks_to_wait - elapsed;
+    }
+    ulTaskNotifyTake(pdTRUE, remaining);
+    atomic_store(waiting_flag, false);
+    return true;
+}
+
+static void wake_peer(atomic_bool *waiting_flag, _Atomic(TaskHandle_t) *peer) {
+    // The fence orders our index store before the flag load; it pairs with the waiter's
+    // seq_cst flag store + re-check, so a wake-up is never lost
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load(waiting_flag)) {
+        TaskHandle_t task = atomic_load(peer);
+        if (task) xTaskNotifyGive(task);
+    }
+}
+
+BaseType_t spsc_ring_send(spsc_ring_t *ring, const void *item, TickType_t ticks_to_wait) {
+    if (atomic_load_explicit(&ring->producer, memory_order_relaxed) == NULL) {
+        atomic_store(&ring->producer, xTaskGetCurrentTaskHandle());
+    }
+    TickType_t start = xTaskGetTickCount();
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    while (1) {
+        uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (ring_distance(ring, head, tail) < ring->capacity) break;
+        if (ticks_to_wait == 0) return errQUEUE_FULL;
+        atomic_store(&ring->producer_waiting, true);
+        if (ring_distance(ring, head, atomic_load(&ring->tail)) < ring->capacity) {
+            atomic_store(&ring->producer_waiting, false);
+            break;
+        }
+        if (!wait_for_peer(&ring->producer_waiting, start, ticks_to_wait)) {
+            atomic_store(&ring->producer_waiting, false);
+            return errQUEUE_FULL;
+        }
+    }
+    memcpy(ring_slot(ring, head), item, ring->item_size);
+    atomic_store_explicit(&ring->head, ring_next(ring, head), memory_order_release);
+    wake_peer(&ring->consumer_waiting, &ring->consumer);
+    return pdPASS;
+}
+
+BaseType_t spsc_ring_receive(spsc_ring_t *ring, void *item, TickType_t ticks_to_wait) {
+    if (atomic_load_explicit(&ring->consumer, memory_order_relaxed) == NULL) {
+        atomic_store(&ring->consumer, xTaskGetCurrentTaskHandle());
+    }
+    TickType_t start = xTaskGetTickCount();
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    while (1) {
+        uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (head != tail) break;
+        if (ticks_to_wait == 0) return errQUEUE_EMPTY;
+        atomic_store(&ring->consumer_waiting, true);
+        if (atomic_load(&ring->head) != tail) {
+            atomic_store(&ring->consumer_waiting, false);
+            break;
+        }
+        if (!wait_for_peer(&ring->consumer_waiting, start, ticks_to_wait)) {
+            atomic_store(&ring->consumer_waiting, false);
+            return errQUEUE_EMPTY;
+        }
+    }
+    memcpy(item, ring_slot(ring, tail), ring->item_size);
+    atomic_store_explicit(&ring->tail, ring_next(ring, tail), memory_order_release);
+    wake_peer(&ring->producer_waiting, &ring->producer);
+    return pdPASS;
+}
+
+uint32_t spsc_ring_count(spsc_ring_t *ring) {
+    uint32_t tail = atomic_load(&ring->tail);
+    return ring_distance(ring, atomic_load(&ring->head), tail);
+}
+
+uint32_t spsc_ring_spaces(spsc_ring_t *ring) {
+    return ring->capacity - spsc_ring_count(ring);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/*
+ * Lock-free single-producer/single-consumer ring buffer.
+ *
+ * Exactly one task may call spsc_ring_send() and exactly one task may call
+ * spsc_ring_receive(). The fast path is two atomic loads, a memcpy and one
+ * atomic store; no critical section is taken. When the ring is empty (or
+ * full) the caller blocks on its task notification (index 0) and the other
+ * side wakes it with xTaskNotifyGive(), so don't combine this with other
+ * uses of the default notification on the same tasks.
+ */
+typedef struct {
+    uint8_t *storage;
+    size_t item_size;
+    uint32_t capacity;
+    _Atomic uint32_t head;              // write index in [0, 2*capacity), owned by the producer
+    _Atomic uint32_t tail;              // read index in [0, 2*capacity), owned by the consumer
+    _Atomic(TaskHandle_t) producer;     // recorded on first send
+    _Atomic(TaskHandle_t) consumer;     // recorded on first receive
+    atomic_bool producer_waiting;
+    atomic_bool consumer_waiting;
+} spsc_ring_t;
+
+// storage must hold capacity * item_size bytes
+bool spsc_ring_init(spsc_ring_t *ring, void *storage, size_t item_size, uint32_t capacity);
+
+// Same return values as xQueueSend/xQueueReceive: pdPASS, or errQUEUE_FULL/errQUEUE_EMPTY on timeout
+BaseType_t spsc_ring_send(spsc_ring_t *ring, const void *item, TickType_t ticks_to_wait);
+BaseType_t spsc_ring_receive(spsc_ring_t *ring, void *item, TickType_t ticks_to_wait);
+
+uint32_t spsc_ring_count(spsc_ring_t *ring);
+uint32_t spsc_ring_spaces(spsc_ring_t *ring);
@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "async_log.h"
+
+typedef union {
+    long long i;
+    double f;
+    const void *p;
+    uint32_t str_offset;
+} log_arg_t;
+
+typedef struct {
+    const char *format;
+    int64_t timestamp_us;
+    uint8_t arg_count;
+    log_arg_t args[ASYNC_LOG_MAX_ARGS];
+    char strings[ASYNC_LOG_STR_BYTES];
+} log_record_t;
+
+// Written only by its owning task (head) and the drain task (tail)
+typedef struct {
+    _Atomic(TaskHandle_t) owner;
+    _Atomic uint32_t head;
+    _Atomic uint32_t tail;
+    _Atomic uint32_t dropped;
+    log_record_t records[ASYNC_LOG_RING_SIZE];
+} log_ring_t;
+
+static log_ring_t rings[ASYNC_LOG_MAX_TASKS];
+static _Atomic uint32_t unregistered_dropped = 0;
+static _Atomic uint32_t records_written = 0;
+
+typedef enum { ARG_NONE, ARG_INT, ARG_LONG, ARG_LLONG, ARG_SIZE, ARG_DOUBLE, ARG_STR, ARG_PTR } arg_kind_t;
+
+// Parses one conversion starting just after '%'. Fills spec (including the '%') and
+// returns the argument kind; *len is set to the number of format chars consumed.
+static arg_kind_t parse_spec(const char *f, char *spec, size_t spec_size, size_t *len) {
+    size_t n = 0;
+    int longs = 0;
+    bool size_mod = false;
+    while (f[n] && strchr("-+ #0123456789.", f[n])) n++;
+    while (f[n] == 'l' || f[n] == 'h' || f[n] == 'z') {
+        if (f[n] == 'l') longs++;
+        if (f[n] == 'z') size_mod = true;
+        n++;
+    }
+    char conv = f[n];
+    if (conv) n++;
+    *len = n;
+    if (spec) {
+        size_t copy = n + 1 < spec_size ? n + 1 : spec_size - 1;
+        spec[0] = '%';
+        memcpy(spec + 1, f, copy - 1);
+        spec[copy] = '\0';
+    }
+    switch (conv) {
+        case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+            return size_mod ? ARG_SIZE : longs >= 2 ? ARG_LLONG : longs == 1 ? ARG_LONG : ARG_INT;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            return ARG_DOUBLE;
+        case 's': return ARG_STR;
+        case 'p': return ARG_PTR;
+        default:  return ARG_NONE;   // "%%" or unsupported
+    }
+}
+
+static log_ring_t *ring_for_current_task(void) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    for (int i = 0; i < ASYNC_LOG_MAX_TASKS; i++) {
+        if (atomic_load_explicit(&rings[i].owner, memory_order_acquire) == self) return &rings[i];
+    }
+    // First log call from this task: claim a free ring (once per task, still lock-free)
+    for (int i = 0; i < ASYNC_LOG_MAX_TASKS; i++) {
+        TaskHandle_t expected = NULL;
+        if (atomic_compare_exchange_strong(&rings[i].owner, &expected, self)) return &rings[i];
+    }
+    return NULL;
+}
+
+void async_log(const char *format, ...) {
+    log_ring_t *ring = ring_for_current_task();
+    if (ring == NULL) {
+        atomic_fetch_add_explicit(&unregistered_dropped, 1, memory_order_relaxed);
+        return;
+    }
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= ASYNC_LOG_RING_SIZE) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    log_record_t *rec = &ring->records[head & (ASYNC_LOG_RING_SIZE - 1)];
+    rec->format = format;
+    rec->timestamp_us = esp_timer_get_time();
+    rec->arg_count = 0;
+    uint32_t str_used = 0;
+
+    va_list ap;
+    va_start(ap, format);
+    for (const char *f = format; *f; f++) {
+        if (*f != '%') continue;
+        size_t len;
+        arg_kind_t kind = parse_spec(f + 1, NULL, 0, &len);
+        f += len;
+        if (kind == ARG_NONE) continue;
+        if (rec->arg_count == ASYNC_LOG_MAX_ARGS) break;
+        log_arg_t *arg = &rec->args[rec->arg_count++];
+        switch (kind) {
+            case ARG_INT:    arg->i = va_arg(ap, int); break;
+            case ARG_LONG:   arg->i = va_arg(ap, long); break;
+            case ARG_LLONG:  arg->i = va_arg(ap, long long); break;
+            case ARG_SIZE:   arg->i = (long long)va_arg(ap, size_t); break;
+            case ARG_DOUBLE: arg->f = va_arg(ap, double); break;
+            case ARG_PTR:    arg->p = va_arg(ap, void *); break;
+            case ARG_STR: {
+                const char *s = va_arg(ap, const char *);
+                if (s == NULL) s = "(null)";
+                size_t room = ASYNC_LOG_STR_BYTES - str_used;
+                size_t n = room ? strnlen(s, room - 1) : 0;
+                arg->str_offset = str_used;
+                if (room) {
+                    memcpy(rec->strings + str_used, s, n);
+                    rec->strings[str_used + n] = '\0';
+                    str_used += n + 1;
+                } else {
+                    arg->str_offset = ASYNC_LOG_STR_BYTES - 1;   // points at the last '\0'
+                }
+                break;
+            }
+            default: break;
+        }
+    }
+    va_end(ap);
+    if (str_used == 0) rec->strings[ASYNC_LOG_STR_BYTES - 1] = '\0';
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+// Formats a record into out; runs only in the drain task
+static void format_record(const log_record_t *rec, char *out, size_t out_size) {
+    size_t pos = 0;
+    uint8_t next_arg = 0;
+    char spec[16];
+    for (const char *f = rec->format; *f && pos + 1 < out_size; ) {
+        if (*f != '%') {
+            out[pos++] = *f++;
+            continue;
+        }
+        size_t len;
+        arg_kind_t kind = parse_spec(f + 1, spec, sizeof(spec), &len);
+        f += 1 + len;
+        if (kind == ARG_NONE) {
+            out[pos++] = '%';
+            continue;
+        }
+        if (next_arg >= rec->arg_count) break;
+        const log_arg_t *arg = &rec->args[next_arg++];
+        size_t room = out_size - pos;
+        int n = 0;
+        switch (kind) {
+            case ARG_INT:    n = snprintf(out + pos, room, spec, (int)arg->i); break;
+            case ARG_LONG:   n = snprintf(out + pos, room, spec, (long)arg->i); break;
+            case ARG_LLONG:  n = snprintf(out + pos, room, spec, arg->i); break;
+            case ARG_SIZE:   n = snprintf(out + pos, room, spec, (size_t)arg->i); break;
+            case ARG_DOUBLE: n = snprintf(out + pos, room, spec, arg->f); break;
+            case ARG_PTR:    n = snprintf(out + pos, room, spec, arg->p); break;
+            case ARG_STR:    n = snprintf(out + pos, room, spec, rec->strings + arg->str_offset); break;
+            default: break;
+        }
+        if (n < 0) break;
+        pos += (size_t)n < room ? (size_t)n : room - 1;
+    }
+    out[pos] = '\0';
+}
+
+static void drain_task(void *pvParameters) {
+    static char line[256];
+    while (1) {
+        bool drained_any = false;
+        // Merge all rings oldest-first so output stays in timestamp order
+        while (1) {
+            log_ring_t *oldest = NULL;
+            const log_record_t *oldest_rec = NULL;
+            for (int i = 0; i < ASYNC_LOG_MAX_TASKS; i++) {
+                log_ring_t *ring = &rings[i];
+                uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+                if (atomic_load_explicit(&ring->head, memory_order_acquire) == tail) continue;
+                const log_record_t *rec = &ring->records[tail & (ASYNC_LOG_RING_SIZE - 1)];
+                if (oldest_rec == NULL || rec->timestamp_us < oldest_rec->timestamp_us) {
+                    oldest = ring;
+                    oldest_rec = rec;
+                }
+            }
+            if (oldest == NULL) break;
+            format_record(oldest_rec, line, sizeof(line));
+            atomic_store_explicit(&oldest->tail, atomic_load_explicit(&oldest->tail, memory_order_relaxed) + 1,
+                                  memory_order_release);
+            fputs(line, stdout);
+            atomic_fetch_add_explicit(&records_written, 1, memory_order_relaxed);
+            drained_any = true;
+        }
+        if (drained_any) fflush(stdout);
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
+}
+
+bool async_log_init(UBaseType_t drain_priority) {
+    return xTaskCreate(drain_task, "LogDrain", 3072, NULL, drain_priority, NULL) == pdPASS;
+}
+
+uint32_t async_log_dropped(void) {
+    uint32_t total = atomic_load(&unregistered_dropped);
+    for (int i = 0; i < ASYNC_LOG_MAX_TASKS; i++) total += atomic_load(&rings[i].dropped);
+    return total;
+}
+
+uint32_t async_log_written(void) {
+    return atomic_load(&records_written);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+
+/*
+ * Asynchronous logger with one lock-free ring per task.
+ *
+ * async_log() only captures the format pointer and the raw arguments into the
+ * calling task's ring; a low-priority drain task formats and prints them in
+ * timestamp order. A full ring drops the record and counts it instead of
+ * blocking the caller.
+ *
+ * Restrictions: the format string must be a literal (only its pointer is
+ * stored), and %s arguments are copied into a small per-record buffer
+ * (ASYNC_LOG_STR_BYTES) and truncated if longer. '*' width/precision is not
+ * supported.
+ */
+
+#define ASYNC_LOG_MAX_TASKS   12
+#define ASYNC_LOG_RING_SIZE   16      // records per task, power of two
+#define ASYNC_LOG_MAX_ARGS    8
+#define ASYNC_LOG_STR_BYTES   48
+
+// Starts the drain task; false if it could not be created (records would never be printed)
+bool async_log_init(UBaseType_t drain_priority);
+void async_log(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+uint32_t async_log_dropped(void);
+uint32_t async_log_written(void);
@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
@@ -9,6 +10,11 @@
 #include "esp_log.h"
 #include "driver/gpio.h"
 #include "esp_random.h"
+#include "esp_timer.h"
+#include "async_log.h"
+#include "lab_metrics.h"
+#include "lab_alloc.h"
+#include "ws_deque.h"
 
 static const char *TAG = "PROD_CONS";
 
@@ -18,17 +24,257 @@ static const char *TAG = "PROD_CONS";
 #define LED_CONSUMER_1 GPIO_NUM_18
 #define LED_CONSUMER_2 GPIO_NUM_19
 
+// 1 = pooled zero-copy hand-off (only a product_t* goes through the queue)
+// 0 = original copy mode (whole product_t copied in and out of the queue)
+#define PRODUCT_HANDOFF_POOLED 1
+#define RUN_HANDOFF_BENCHMARK 1
+// Consumers block for the first product, then drain up to BATCH_MAX-1 more without waiting.
+// 1 = one product per wake-up (original behaviour)
+#define CONSUMER_BATCH_MAX 4
+// 1 = per-task lock-free log rings drained by a low-priority task
+// 0 = safe_printf() serialised on xPrintMutex
+#define USE_ASYNC_LOG 1
+// 1 = work stealing: each consumer has its own deque, producers push to the least-loaded
+//     active consumer and an idle consumer steals the newest item from the busiest peer
+// 0 = every producer and consumer shares xProductQueue (original design)
+#define USE_WORK_STEALING 1
+
+#define PRODUCT_QUEUE_LENGTH 10
+#define NUM_PRODUCERS 3
+#define NUM_CONSUMERS 2           // Always running
+#define MAX_CONSUMERS 4           // Upper bound for the load balancer
+// Every queued item plus one slot being filled per producer and a batch being processed per consumer
+#define PRODUCT_POOL_SIZE (PRODUCT_QUEUE_LENGTH + NUM_PRODUCERS + MAX_CONSUMERS * CONSUMER_BATCH_MAX)
+
+#if USE_WORK_STEALING && !PRODUCT_HANDOFF_POOLED
+#error "Work stealing moves product pointers between deques; set PRODUCT_HANDOFF_POOLED to 1"
+#endif
+
+// Autoscaler: add a consumer above the high watermark, park one after the queue has
+// stayed at or below the low watermark for SCALE_DOWN_HOLD_S consecutive seconds
+#define SCALE_UP_DEPTH 8
+#define SCALE_DOWN_DEPTH 2
+#define SCALE_DOWN_HOLD_S 5
+#define SCALE_COOLDOWN_S 3
+
 QueueHandle_t xProductQueue;
+#if !USE_ASYNC_LOG
 SemaphoreHandle_t xPrintMutex;
+#endif
 
-typedef struct { uint32_t produced; uint32_t consumed; uint32_t dropped; } stats_t;
-stats_t global_stats = {0, 0, 0};
+// Counters are sharded per core and updated atomically, so concurrent producers/consumers never lose counts
+typedef struct {
+    lab_counter_t *produced, *consumed, *dropped, *batches;
+    lab_gauge_t *queue_depth;
+    lab_histogram_t *batch_size;
+    lab_gauge_t *active_consumers;
+    lab_histogram_t *queue_wait_us[MAX_CONSUMERS];   // production -> dequeue, per product
+    lab_histogram_t *processing_us[MAX_CONSUMERS];   // dequeue -> finished, per wake-up (batch)
+    lab_counter_t *steals[MAX_CONSUMERS];            // items taken from a peer's deque
+    lab_counter_t *idle_ms[MAX_CONSUMERS];           // time spent waiting for work while active
+    lab_histogram_t *e2e_us;                         // production -> finished, all consumers
+} stats_t;
+stats_t global_stats;
+
+static bool stats_init(void) {
+    global_stats.produced = lab_counter("produced");
+    global_stats.consumed = lab_counter("consumed");
+    global_stats.dropped = lab_counter("dropped");
+    global_stats.batches = lab_counter("batches");
+    global_stats.queue_depth = lab_gauge("queue_depth");
+    global_stats.batch_size = lab_histogram("batch_size");
+    global_stats.active_consumers = lab_gauge("active_consumers");
+    global_stats.e2e_us = lab_histogram("e2e_us");
+    bool ok = global_stats.produced && global_stats.consumed && global_stats.dropped &&
+              global_stats.batches && global_stats.queue_depth && global_stats.batch_size &&
+              global_stats.active_consumers && global_stats.e2e_us;
+    for (int i = 0; i < MAX_CONSUMERS; i++) {
+        char name[LAB_METRICS_NAME_LEN];
+        snprintf(name, sizeof(name), "c%d_queue_wait_us", i + 1);
+        global_stats.queue_wait_us[i] = lab_histogram(name);
+        snprintf(name, sizeof(name), "c%d_processing_us", i + 1);
+        global_stats.processing_us[i] = lab_histogram(name);
+        snprintf(name, sizeof(name), "c%d_steals", i + 1);
+        global_stats.steals[i] = lab_counter(name);
+        snprintf(name, sizeof(name), "c%d_idle_ms", i + 1);
+        global_stats.idle_ms[i] = lab_counter(name);
+        ok = ok && global_stats.queue_wait_us[i] && global_stats.processing_us[i] &&
+             global_stats.steals[i] && global_stats.idle_ms[i];
+    }
+    return ok;
+}
 
 typedef struct {
     int producer_id; int product_id; char product_name[30];
-    uint32_t production_time; int processing_time_ms;
+    int64_t production_us; int processing_time_ms;
 } product_t;
 
+#if PRODUCT_HANDOFF_POOLED
+typedef product_t *product_msg_t;       // What travels through xProductQueue
+#define PRODUCT_OF(msg) (msg)
+#else
+typedef product_t product_msg_t;
+#define PRODUCT_OF(msg) (&(msg))
+#endif
+
+// Blocks up to first_wait for one item, then pulls at most max_items-1 more with zero
+// timeout. Returns the number of items written to items (each item_size bytes).
+UBaseType_t queue_receive_batch(QueueHandle_t queue, void *items, size_t item_size,
+                                UBaseType_t max_items, TickType_t first_wait) {
+    uint8_t *dst = (uint8_t *)items;
+    if (max_items == 0 || xQueueReceive(queue, dst, first_wait) != pdPASS) return 0;
+    UBaseType_t count = 1;
+    while (count < max_items && xQueueReceive(queue, dst + count * item_size, 0) == pdPASS) {
+        count++;
+    }
+    return count;
+}
+
+#if PRODUCT_HANDOFF_POOLED
+// Fixed pool of products; free slots are handed around as pointers
+static product_t product_pool[PRODUCT_POOL_SIZE];
+QueueHandle_t xFreeSlotQueue;
+
+static product_t *product_alloc(TickType_t wait) {
+    product_t *slot = NULL;
+    return xQueueReceive(xFreeSlotQueue, &slot, wait) == pdPASS ? slot : NULL;
+}
+
+static void product_free(product_t *slot) {
+    xQueueSend(xFreeSlotQueue, &slot, 0); // Never blocks: the free queue holds the whole pool
+}
+#endif
+
+// Elastic consumers (ids NUM_CONSUMERS+1..MAX_CONSUMERS) are created on first scale-up.
+// Scaling down parks them at the top of their loop rather than vTaskSuspend()ing them,
+// so a consumer is never frozen while it holds pool slots or has its LED on.
+static TaskHandle_t consumer_handles[MAX_CONSUMERS];
+static volatile bool consumer_active[MAX_CONSUMERS];
+static int consumer_ids[MAX_CONSUMERS];
+#if LAB_STATIC_ALLOCATION
+// Consumers are parked rather than deleted, so each slot keeps its stack for the whole run
+static StackType_t consumer_stacks[MAX_CONSUMERS][3072];
+static StaticTask_t consumer_tcbs[MAX_CONSUMERS];
+#endif
+
+#if USE_WORK_STEALING
+// The total across all deques is capped at PRODUCT_QUEUE_LENGTH, the same backlog the
+// shared queue allows, so both designs drop under the same load
+static ws_deque_t consumer_deques[MAX_CONSUMERS];
+static void *deque_storage[MAX_CONSUMERS][PRODUCT_QUEUE_LENGTH];
+static volatile bool consumer_idle[MAX_CONSUMERS];
+static uint32_t queued_products;
+
+static void work_stealing_init(void) {
+    for (int i = 0; i < MAX_CONSUMERS; i++) ws_deque_init(&consumer_deques[i], deque_storage[i], PRODUCT_QUEUE_LENGTH);
+}
+
+static bool reserve_backlog_slot(void) {
+    uint32_t n = __atomic_load_n(&queued_products, __ATOMIC_RELAXED);
+    do {
+        if (n >= PRODUCT_QUEUE_LENGTH) return false;
+    } while (!__atomic_compare_exchange_n(&queued_products, &n, n + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    return true;
+}
+
+static void wake_consumer(int index) {
+    if (consumer_handles[index] != NULL) xTaskNotifyGive(consumer_handles[index]);
+}
+
+static BaseType_t product_submit(const product_msg_t *msg, TickType_t wait) {
+    TickType_t start = xTaskGetTickCount();
+    while (!reserve_backlog_slot()) {
+        if (xTaskGetTickCount() - start >= wait) return errQUEUE_FULL;
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    // Least-loaded active consumer; on a tie prefer one that is waiting for work
+    int target = -1;
+    for (int i = 0; i < MAX_CONSUMERS; i++) {
+        if (!consumer_active[i]) continue;
+        if (target < 0) { target = i; continue; }
+        uint32_t n = ws_deque_count(&consumer_deques[i]), best = ws_deque_count(&consumer_deques[target]);
+        if (n < best || (n == best && consumer_idle[i] && !consumer_idle[target])) target = i;
+    }
+    if (target < 0) target = 0;   // Before the first consumer starts
+    // The backlog cap equals each deque's capacity, so this only fails if the two diverge
+    int pushed = -1;
+    for (int k = 0; k < MAX_CONSUMERS && pushed < 0; k++) {
+        int i = (target + k) % MAX_CONSUMERS;
+        if ((i == target || consumer_active[i]) && ws_deque_push(&consumer_deques[i], *msg)) pushed = i;
+    }
+    if (pushed < 0) {
+        __atomic_sub_fetch(&queued_products, 1, __ATOMIC_RELAXED);
+        return errQUEUE_FULL;   // The caller drops the product and returns its slot
+    }
+    target = pushed;
+    wake_consumer(target);
+    // The owner may be in the middle of a long job, so give an idle peer the chance to steal it now
+    if (!consumer_idle[target]) {
+        for (int i = 0; i < MAX_CONSUMERS; i++) {
+            if (i != target && consumer_active[i] && consumer_idle[i]) { wake_consumer(i); break; }
+        }
+    }
+    return pdPASS;
+}
+
+// Oldest items from the consumer's own deque first; otherwise one item stolen from the tail of
+// the fullest peer (parked consumers included). Blocks up to wait when there is no work anywhere.
+static UBaseType_t product_take(int index, product_msg_t *batch, UBaseType_t max_items, TickType_t wait, bool *stolen) {
+    TickType_t start = xTaskGetTickCount();
+    while (1) {
+        consumer_idle[index] = true;   // Set before looking, so a producer pushing meanwhile wakes us
+        *stolen = false;
+        uint32_t n = ws_deque_pop(&consumer_deques[index], (void **)batch, max_items);
+        if (n == 0) {
+            int victim = -1;
+            for (int i = 0; i < MAX_CONSUMERS; i++) {
+                if (i == index || ws_deque_count(&consumer_deques[i]) == 0) continue;
+                if (victim < 0 || ws_deque_count(&consumer_deques[i]) > ws_deque_count(&consumer_deques[victim])) victim = i;
+            }
+            if (victim >= 0 && ws_deque_steal(&consumer_deques[victim], (void **)&batch[0])) {
+                n = 1;
+                *stolen = true;
+            }
+        }
+        if (n > 0) {
+            consumer_idle[index] = false;
+            __atomic_sub_fetch(&queued_products, n, __ATOMIC_RELAXED);
+            return n;
+        }
+        TickType_t waited = xTaskGetTickCount() - start;
+        if (waited >= wait) { consumer_idle[index] = false; return 0; }
+        ulTaskNotifyTake(pdTRUE, wait - waited);
+    }
+}
+
+static UBaseType_t product_queue_depth(void) {
+    return __atomic_load_n(&queued_products, __ATOMIC_RELAXED);
+}
+#else
+static BaseType_t product_submit(const product_msg_t *msg, TickType_t wait) {
+    return xQueueSend(xProductQueue, msg, wait);
+}
+
+static UBaseType_t product_take(int index, product_msg_t *batch, UBaseType_t max_items, TickType_t wait, bool *stolen) {
+    (void)index;
+    *stolen = false;
+    return queue_receive_batch(xProductQueue, batch, sizeof(batch[0]), max_items, wait);
+}
+
+static UBaseType_t product_queue_depth(void) {
+    return uxQueueMessagesWaiting(xProductQueue);
+}
+#endif
+
+#if USE_ASYNC_LOG
+static bool async_log_ready = false;   // false: LogDrain could not be started, print directly
+
+// Never blocks: the record goes into the caller's own ring, LogDrain formats it later
+#define safe_printf(...) do { \
+        if (async_log_ready) async_log(__VA_ARGS__); \
+        else printf(__VA_ARGS__); \
+    } while (0)
+#else
 void safe_printf(const char* format, ...) {
     va_list args;
     va_start(args, format);
@@ -38,27 +284,51 @@ void safe_printf(const char* format, ...) {
     }
     va_end(args);
 }
+#endif
 
 void producer_task(void *pvParameters) {
     int producer_id = *((int*)pvParameters);
-    product_t product;
+#if PRODUCT_HANDOFF_POOLED
+    product_t *product;
+#else
+    product_t local_product;
+    product_t *product = &local_product;
+#endif
     int product_counter = 0;
     gpio_num_t led_pin = (producer_id == 1) ? LED_PRODUCER_1 : (producer_id == 2) ? LED_PRODUCER_2 : LED_PRODUCER_3;
     safe_printf("Producer %d started\n", producer_id);
     while (1) {
-        product.producer_id = producer_id;
-        product.product_id = product_counter++;
-        snprintf(product.product_name, sizeof(product.product_name), "Product-P%d-#%d", producer_id, product.product_id);
-        product.production_time = xTaskGetTickCount();
-        product.processing_time_ms = 500 + (esp_random() % 2000);
-
-        if (xQueueSend(xProductQueue, &product, pdMS_TO_TICKS(100)) == pdPASS) {
-            global_stats.produced++;
-            safe_printf("✓ P%d: Created %s (%dms)\n", producer_id, product.product_name, product.processing_time_ms);
+#if PRODUCT_HANDOFF_POOLED
+        product = product_alloc(pdMS_TO_TICKS(100));
+        if (product == NULL) {
+            lab_counter_inc(global_stats.dropped);
+            safe_printf("✗ P%d: Pool empty! Dropped product #%d\n", producer_id, product_counter++);
+            vTaskDelay(pdMS_TO_TICKS(1000 + (esp_random() % 2000)));
+            continue;
+        }
+#endif
+        product->producer_id = producer_id;
+        product->product_id = product_counter++;
+        snprintf(product->product_name, sizeof(product->product_name), "Product-P%d-#%d", producer_id, product->product_id);
+        product->production_us = esp_timer_get_time();
+        product->processing_time_ms = 500 + (esp_random() % 2000);
+
+#if PRODUCT_HANDOFF_POOLED
+        BaseType_t sent = product_submit(&product, pdMS_TO_TICKS(100));
+#else
+        BaseType_t sent = product_submit(product, pdMS_TO_TICKS(100));
+#endif
+        if (sent == pdPASS) {
+            lab_counter_inc(global_stats.produced);
+            // Pooled: the slot now belongs to the consumer, only read back what we still own
+            safe_printf("✓ P%d: Created product #%d\n", producer_id, product_counter - 1);
             gpio_set_level(led_pin, 1); vTaskDelay(pdMS_TO_TICKS(50)); gpio_set_level(led_pin, 0);
         } else {
-            global_stats.dropped++;
-            safe_printf("✗ P%d: Queue full! Dropped %s\n", producer_id, product.product_name);
+            lab_counter_inc(global_stats.dropped);
+            safe_printf("✗ P%d: Queue full! Dropped %s\n", producer_id, product->product_name);
+#if PRODUCT_HANDOFF_POOLED
+            product_free(product);
+#endif
         }
         vTaskDelay(pdMS_TO_TICKS(1000 + (esp_random() % 2000)));
     }
@@ -66,18 +336,52 @@ void producer_task(void *pvParameters) {
 
 void consumer_task(void *pvParameters) {
     int consumer_id = *((int*)pvParameters);
-    product_t product;
-    gpio_num_t led_pin = (consumer_id == 1) ? LED_CONSUMER_1 : LED_CONSUMER_2;
+    product_msg_t batch[CONSUMER_BATCH_MAX];
+    int64_t idle_us = 0;   // not yet added to the idle_ms counter
+    gpio_num_t led_pin = (consumer_id == 1) ? LED_CONSUMER_1 : (consumer_id == 2) ? LED_CONSUMER_2 : GPIO_NUM_NC;
     safe_printf("Consumer %d started\n", consumer_id);
     while (1) {
-        if (xQueueReceive(xProductQueue, &product, pdMS_TO_TICKS(5000)) == pdPASS) {
-            global_stats.consumed++;
-            uint32_t queue_time = (xTaskGetTickCount() - product.production_time) * portTICK_PERIOD_MS;
-            safe_printf("→ C%d: Processing %s (q_time: %lums)\n", consumer_id, product.product_name, queue_time);
-            gpio_set_level(led_pin, 1);
-            vTaskDelay(pdMS_TO_TICKS(product.processing_time_ms));
-            gpio_set_level(led_pin, 0);
-            safe_printf("✓ C%d: Finished %s\n", consumer_id, product.product_name);
+        if (!consumer_active[consumer_id - 1]) {
+            safe_printf("💤 C%d: Parked\n", consumer_id);
+            while (!consumer_active[consumer_id - 1]) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            safe_printf("▶ C%d: Resumed\n", consumer_id);
+        }
+        bool stolen;
+        int64_t wait_start_us = esp_timer_get_time();
+        UBaseType_t count = product_take(consumer_id - 1, batch, CONSUMER_BATCH_MAX, pdMS_TO_TICKS(5000), &stolen);
+        int64_t dequeued_us = esp_timer_get_time();
+        idle_us += dequeued_us - wait_start_us;
+        lab_counter_add(global_stats.idle_ms[consumer_id - 1], (uint32_t)(idle_us / 1000));
+        idle_us %= 1000;
+        if (count > 0) {
+            if (stolen) lab_counter_inc(global_stats.steals[consumer_id - 1]);
+            lab_counter_add(global_stats.consumed, count);
+            lab_counter_inc(global_stats.batches);
+            lab_hist_record(global_stats.batch_size, count);
+            // One wake-up and one sleep for the whole batch
+            int batch_time_ms = 0;
+            for (UBaseType_t i = 0; i < count; i++) {
+                product_t *product = PRODUCT_OF(batch[i]);
+                uint32_t queue_us = (uint32_t)(dequeued_us - product->production_us);
+                lab_hist_record(global_stats.queue_wait_us[consumer_id - 1], queue_us);
+                safe_printf("→ C%d: Processing %s (q_time: %lu.%03lums, batch %lu/%lu)%s\n", consumer_id,
+                            product->product_name, (unsigned long)(queue_us / 1000), (unsigned long)(queue_us % 1000),
+                            (unsigned long)(i + 1), (unsigned long)count, stolen ? " [stolen]" : "");
+                batch_time_ms += product->processing_time_ms;
+            }
+            if (led_pin != GPIO_NUM_NC) gpio_set_level(led_pin, 1);
+            vTaskDelay(pdMS_TO_TICKS(batch_time_ms));
+            if (led_pin != GPIO_NUM_NC) gpio_set_level(led_pin, 0);
+            int64_t finished_us = esp_timer_get_time();
+            lab_hist_record(global_stats.processing_us[consumer_id - 1], (uint32_t)(finished_us - dequeued_us));
+            for (UBaseType_t i = 0; i < count; i++) {
+                product_t *product = PRODUCT_OF(batch[i]);
+                lab_hist_record(global_stats.e2e_us, (uint32_t)(finished_us - product->production_us));
+                safe_printf("✓ C%d: Finished %s\n", consumer_id, product->product_name);
+#if PRODUCT_HANDOFF_POOLED
+                product_free(product);
+#endif
+            }
         } else {
             safe_printf("⏰ C%d: No products (timeout)\n", consumer_id);
         }
@@ -86,27 +390,220 @@ void consumer_task(void *pvParameters) {
 
 void statistics_task(void *pvParameters) {
     safe_printf("Statistics task started\n");
+    uint32_t last_consumed = 0, last_batches = 0;
+    uint32_t last_idle_ms[MAX_CONSUMERS] = {0}, last_steals[MAX_CONSUMERS] = {0};
+    TickType_t last_tick = xTaskGetTickCount();
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(5000));
-        UBaseType_t queue_items = uxQueueMessagesWaiting(xProductQueue);
-        float efficiency = global_stats.produced > 0 ? (float)global_stats.consumed / global_stats.produced * 100 : 0;
+        UBaseType_t queue_items = product_queue_depth();
+        lab_gauge_set(global_stats.queue_depth, queue_items);
+        uint32_t produced = lab_counter_read(global_stats.produced);
+        uint32_t consumed = lab_counter_read(global_stats.consumed);
+        uint32_t dropped = lab_counter_read(global_stats.dropped);
+        uint32_t batches = lab_counter_read(global_stats.batches);
+        float efficiency = produced > 0 ? (float)consumed / produced * 100 : 0;
         safe_printf("\n═══ STATS | Produced: %lu | Consumed: %lu | Dropped: %lu | Efficiency: %.1f%% ═══\n",
-                    global_stats.produced, global_stats.consumed, global_stats.dropped, efficiency);
-        printf("Queue: [\" );
-        for (int i = 0; i < 10; i++) { printf(i < queue_items ? "■" : "□"); }
-        printf("] (%d items)\n\n", queue_items);
+                    (unsigned long)produced, (unsigned long)consumed, (unsigned long)dropped, efficiency);
+
+        TickType_t now = xTaskGetTickCount();
+        uint32_t d_items = consumed - last_consumed, d_batches = batches - last_batches;
+        uint32_t elapsed_ms = (now - last_tick) * portTICK_PERIOD_MS;
+        safe_printf("Batching: avg %.2f items/batch (%lu wake-ups for %lu items) | %.2f items/s\n",
+                    d_batches ? (float)d_items / d_batches : 0.0f, (unsigned long)d_batches, (unsigned long)d_items,
+                    elapsed_ms ? d_items * 1000.0f / elapsed_ms : 0.0f);
+        last_consumed = consumed; last_batches = batches; last_tick = now;
+
+        // Idle = waiting for work while active (parked time is not counted)
+        for (int i = 0; i < MAX_CONSUMERS; i++) {
+            if (consumer_handles[i] == NULL) continue;
+            uint32_t idle_ms = lab_counter_read(global_stats.idle_ms[i]), steals = lab_counter_read(global_stats.steals[i]);
+            safe_printf("C%d: idle %.1f%% | steals +%lu (total %lu)%s\n", i + 1,
+                        elapsed_ms ? 100.0f * (idle_ms - last_idle_ms[i]) / elapsed_ms : 0.0f,
+                        (unsigned long)(steals - last_steals[i]), (unsigned long)steals,
+                        consumer_active[i] ? "" : " [parked]");
+            last_idle_ms[i] = idle_ms;
+            last_steals[i] = steals;
+        }
+        lab_hist_summary_t e2e;
+        lab_hist_summary(global_stats.e2e_us, &e2e);
+        safe_printf("E2E latency us (%s): n=%lu p50=%lu p90=%lu p99=%lu max=%lu\n",
+                    USE_WORK_STEALING ? "work stealing" : "shared queue", (unsigned long)e2e.count,
+                    (unsigned long)e2e.p50, (unsigned long)e2e.p90, (unsigned long)e2e.p99, (unsigned long)e2e.max);
+
+        // Cumulative since boot; values are bucket upper bounds (≤12.5% over)
+        for (int i = 0; i < MAX_CONSUMERS; i++) {
+            lab_hist_summary_t wait, proc;
+            lab_hist_summary(global_stats.queue_wait_us[i], &wait);
+            lab_hist_summary(global_stats.processing_us[i], &proc);
+            if (i >= NUM_CONSUMERS && wait.count == 0) continue;   // Elastic consumer never used
+            safe_printf("C%d queue wait us: n=%lu p50=%lu p90=%lu p99=%lu max=%lu\n", i + 1,
+                        (unsigned long)wait.count, (unsigned long)wait.p50, (unsigned long)wait.p90,
+                        (unsigned long)wait.p99, (unsigned long)wait.max);
+            safe_printf("C%d processing us: n=%lu p50=%lu p90=%lu p99=%lu max=%lu\n", i + 1,
+                        (unsigned long)proc.count, (unsigned long)proc.p50, (unsigned long)proc.p90,
+                        (unsigned long)proc.p99, (unsigned long)proc.max);
+        }
+        char bar[PRODUCT_QUEUE_LENGTH * 3 + 1] = "";
+        for (int i = 0; i < PRODUCT_QUEUE_LENGTH; i++) { strcat(bar, i < queue_items ? "■" : "□"); }
+        safe_printf("Queue: [%s] (%lu items)\n\n", bar, (unsigned long)queue_items);
+#if USE_ASYNC_LOG
+        if (async_log_ready) {
+            safe_printf("Log: %lu written, %lu dropped (ring full)\n", (unsigned long)async_log_written(),
+                        (unsigned long)async_log_dropped());
+        }
+#endif
     }
 }
 
+static bool start_consumer(int index) {
+    consumer_active[index] = true;
+    if (consumer_handles[index] != NULL) {
+        xTaskNotifyGive(consumer_handles[index]);
+        return true;
+    }
+    char name[configMAX_TASK_NAME_LEN];
+    snprintf(name, sizeof(name), "Consumer%d", consumer_ids[index]);
+#if LAB_STATIC_ALLOCATION
+    consumer_handles[index] = xTaskCreateStatic(consumer_task, name, 3072, &consumer_ids[index], 2,
+                                                consumer_stacks[index], &consumer_tcbs[index]);
+    if (consumer_handles[index] == NULL) {
+#else
+    if (xTaskCreate(consumer_task, name, 3072, &consumer_ids[index], 2, &consumer_handles[index]) != pdPASS) {
+#endif
+        consumer_active[index] = false;
+        return false;
+    }
+    return true;
+}
+
 void load_balancer_task(void *pvParameters) {
     safe_printf("Load balancer started\n");
+    int active = NUM_CONSUMERS;
+    int calm_seconds = 0, cooldown = 0;
+    uint32_t dropped_at_last_event = lab_counter_read(global_stats.dropped);
+    TickType_t last_event_tick = xTaskGetTickCount();
+    lab_gauge_set(global_stats.active_consumers, active);
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(1000));
-        if (uxQueueMessagesWaiting(xProductQueue) > 8) {
-            safe_printf("⚠️ HIGH LOAD DETECTED! Queue > 8\n");
+        UBaseType_t depth = product_queue_depth();
+        lab_gauge_set(global_stats.queue_depth, depth);
+        calm_seconds = depth <= SCALE_DOWN_DEPTH ? calm_seconds + 1 : 0;
+        if (cooldown > 0) { cooldown--; continue; }
+
+        int change = 0;
+        if (depth > SCALE_UP_DEPTH && active < MAX_CONSUMERS) {
+            if (start_consumer(active)) change = 1;
+            else safe_printf("⚠️ HIGH LOAD: could not start Consumer%d\n", active + 1);
+        } else if (depth > SCALE_UP_DEPTH) {
+            safe_printf("⚠️ HIGH LOAD DETECTED! Queue > %d with all %d consumers running\n", SCALE_UP_DEPTH, MAX_CONSUMERS);
+        } else if (calm_seconds >= SCALE_DOWN_HOLD_S && active > NUM_CONSUMERS) {
+            consumer_active[active - 1] = false;   // Parks itself after its current batch
+            change = -1;
         }
+        if (change == 0) continue;
+
+        // Report the event together with what dropped did since the previous one
+        uint32_t dropped = lab_counter_read(global_stats.dropped);
+        TickType_t now = xTaskGetTickCount();
+        safe_printf("%s SCALE %s → %d consumers (queue %lu) | dropped +%lu in last %lus\n",
+                    change > 0 ? "⬆" : "⬇", change > 0 ? "UP" : "DOWN", active + change,
+                    (unsigned long)depth, (unsigned long)(dropped - dropped_at_last_event),
+                    (unsigned long)((now - last_event_tick) * portTICK_PERIOD_MS / 1000));
+        active += change;
+        lab_gauge_set(global_stats.active_consumers, active);
+        dropped_at_last_event = dropped;
+        last_event_tick = now;
+        calm_seconds = 0;
+        cooldown = SCALE_COOLDOWN_S;
+    }
+}
+
+#if RUN_HANDOFF_BENCHMARK
+// Times N send+receive pairs through a scratch queue in both modes, from a single task,
+// so the number is pure hand-off cost (copies + queue bookkeeping, no context switches)
+static void handoff_benchmark(void) {
+    const int iterations = 2000;
+    static product_t bench_pool[PRODUCT_QUEUE_LENGTH];
+    product_t in = { .producer_id = 1, .product_name = "Product-P1-#0", .processing_time_ms = 1000 }, out;
+    product_t *ptr_in, *ptr_out;
+
+    QueueHandle_t copy_q = xQueueCreate(PRODUCT_QUEUE_LENGTH, sizeof(product_t));
+    QueueHandle_t ptr_q = xQueueCreate(PRODUCT_QUEUE_LENGTH, sizeof(product_t *));
+    // Scratch free list, so the pooled loop pays for product_alloc()/product_free() too
+    QueueHandle_t free_q = xQueueCreate(PRODUCT_QUEUE_LENGTH, sizeof(product_t *));
+    if (!copy_q || !ptr_q || !free_q) {
+        ESP_LOGE(TAG, "Benchmark queues could not be created");
+        if (copy_q) vQueueDelete(copy_q);
+        if (ptr_q) vQueueDelete(ptr_q);
+        if (free_q) vQueueDelete(free_q);
+        return;
+    }
+    for (int i = 0; i < PRODUCT_QUEUE_LENGTH; i++) {
+        ptr_in = &bench_pool[i];
+        xQueueSend(free_q, &ptr_in, 0);
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        in.product_id = i;
+        xQueueSend(copy_q, &in, 0);
+        xQueueReceive(copy_q, &out, 0);
+    }
+    int64_t copy_us = esp_timer_get_time() - t0;
+
+    t0 = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        xQueueReceive(free_q, &ptr_in, 0);     // product_alloc()
+        ptr_in->product_id = i;
+        xQueueSend(ptr_q, &ptr_in, 0);
+        xQueueReceive(ptr_q, &ptr_out, 0);
+        xQueueSend(free_q, &ptr_out, 0);       // product_free()
     }
+    int64_t ptr_us = esp_timer_get_time() - t0;
+
+    vQueueDelete(copy_q);
+    vQueueDelete(ptr_q);
+    vQueueDelete(free_q);
+
+    ESP_LOGI(TAG, "Hand-off benchmark (%d items, sizeof(product_t)=%u)", iterations, (unsigned)sizeof(product_t));
+    ESP_LOGI(TAG, "  copy mode  : %lld us total, %.2f us/item, %.0f items/s, 2 queue ops, %u bytes copied/item",
+             copy_us, (float)copy_us / iterations, iterations * 1e6f / (copy_us ? copy_us : 1), (unsigned)(2 * sizeof(product_t)));
+    ESP_LOGI(TAG, "  pooled mode: %lld us total, %.2f us/item, %.0f items/s, 4 queue ops, %u bytes copied/item (incl. alloc/free)",
+             ptr_us, (float)ptr_us / iterations, iterations * 1e6f / (ptr_us ? ptr_us : 1), (unsigned)(4 * sizeof(product_t *)));
+    ESP_LOGI(TAG, "  RAM copy   : queue storage %u bytes",
+             (unsigned)(PRODUCT_QUEUE_LENGTH * sizeof(product_t)));
+    ESP_LOGI(TAG, "  RAM pooled : queue storage %u + free list %u + pool %u = %u bytes",
+             (unsigned)(PRODUCT_QUEUE_LENGTH * sizeof(product_t *)), (unsigned)(PRODUCT_POOL_SIZE * sizeof(product_t *)),
+             (unsigned)(PRODUCT_POOL_SIZE * sizeof(product_t)),
+             (unsigned)((PRODUCT_QUEUE_LENGTH + PRODUCT_POOL_SIZE) * sizeof(product_t *) + PRODUCT_POOL_SIZE * sizeof(product_t)));
 }
+#endif
+
+static int p_ids[] = {1, 2, 3};
+
+static const lab_object_def_t lab_objects[] = {
+#if PRODUCT_HANDOFF_POOLED
+#if !USE_WORK_STEALING
+    LAB_QUEUE(&xProductQueue, PRODUCT_QUEUE_LENGTH, sizeof(product_t *)),
+#endif
+    LAB_QUEUE(&xFreeSlotQueue, PRODUCT_POOL_SIZE, sizeof(product_t *)),
+#else
+    LAB_QUEUE(&xProductQueue, PRODUCT_QUEUE_LENGTH, sizeof(product_t)),
+#endif
+#if !USE_ASYNC_LOG
+    LAB_MUTEX(&xPrintMutex),
+#endif
+};
+
+// Consumers are started by start_consumer() so the load balancer can add more later
+static const lab_task_def_t lab_tasks[] = {
+    LAB_TASK(producer_task, "Producer1", 3072, &p_ids[0], 3, NULL),
+    LAB_TASK(producer_task, "Producer2", 3072, &p_ids[1], 3, NULL),
+    LAB_TASK(producer_task, "Producer3", 3072, &p_ids[2], 3, NULL),
+    LAB_TASK(statistics_task, "Statistics", 3072, NULL, 1, NULL),
+    // Above the producers so scaling decisions are not delayed by a burst
+    LAB_TASK(load_balancer_task, "LoadBalancer", 3072, NULL, 4, NULL),
+};
 
 void app_main(void) {
     ESP_LOGI(TAG, "Producer-Consumer System Lab Starting...");
@@ -114,20 +611,40 @@ void app_main(void) {
     io_conf.pin_bit_mask = (1ULL<<LED_PRODUCER_1)|(1ULL<<LED_PRODUCER_2)|(1ULL<<LED_PRODUCER_3)|(1ULL<<LED_CONSUMER_1)|(1ULL<<LED_CONSUMER_2);
     gpio_config(&io_conf);
 
-    xProductQueue = xQueueCreate(10, sizeof(product_t));
-    xPrintMutex = xSemaphoreCreateMutex();
-
-    if (xProductQueue != NULL && xPrintMutex != NULL) {
-        ESP_LOGI(TAG, "Queue and mutex created successfully");
-        static int p_ids[] = {1, 2, 3}; static int c_ids[] = {1, 2};
-        xTaskCreate(producer_task, "Producer1", 3072, &p_ids[0], 3, NULL);
-        xTaskCreate(producer_task, "Producer2", 3072, &p_ids[1], 3, NULL);
-        xTaskCreate(producer_task, "Producer3", 3072, &p_ids[2], 3, NULL);
-        xTaskCreate(consumer_task, "Consumer1", 3072, &c_ids[0], 2, NULL);
-        xTaskCreate(consumer_task, "Consumer2", 3072, &c_ids[1], 2, NULL);
-        xTaskCreate(statistics_task, "Statistics", 3072, NULL, 1, NULL);
-        xTaskCreate(load_balancer_task, "LoadBalancer", 2048, NULL, 1, NULL);
+#if RUN_HANDOFF_BENCHMARK
+    handoff_benchmark();
+#endif
+
+    bool objects_ready = lab_objects_create(lab_objects, LAB_ARRAY_SIZE(lab_objects));
+#if USE_WORK_STEALING
+    work_stealing_init();
+#endif
+#if PRODUCT_HANDOFF_POOLED
+    if (xFreeSlotQueue != NULL) {
+        for (int i = 0; i < PRODUCT_POOL_SIZE; i++) {
+            product_t *slot = &product_pool[i];
+            xQueueSend(xFreeSlotQueue, &slot, 0);
+        }
+    }
+#endif
+#if USE_ASYNC_LOG
+    async_log_ready = async_log_init(1);   // Below producers (3) and consumers (2)
+    if (!async_log_ready) {
+        ESP_LOGE(TAG, "Failed to start LogDrain, printing directly");
+    }
+#endif
+
+    if (objects_ready && stats_init()) {
+#if PRODUCT_HANDOFF_POOLED
+        ESP_LOGI(TAG, "Queue, pool (%d slots) and logger created successfully", PRODUCT_POOL_SIZE);
+#else
+        ESP_LOGI(TAG, "Queue and logger created successfully");
+#endif
+        for (int i = 0; i < MAX_CONSUMERS; i++) consumer_ids[i] = i + 1;
+        lab_tasks_create(lab_tasks, LAB_ARRAY_SIZE(lab_tasks));
+        for (int i = 0; i < NUM_CONSUMERS; i++) start_consumer(i);
+        lab_alloc_report(TAG);
     } else {
-        ESP_LOGE(TAG, "Failed to create queue or mutex!");
+        ESP_LOGE(TAG, "Failed to create queue or logger!");
     }
 }
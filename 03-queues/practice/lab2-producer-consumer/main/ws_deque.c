@@ -0,0 +1,47 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "ws_deque.h"
+
+void ws_deque_init(ws_deque_t *dq, void **storage, uint32_t capacity) {
+    dq->slots = storage;
+    dq->capacity = capacity;
+    dq->head = 0;
+    dq->count = 0;
+    dq->mux = (portMUX_TYPE)portMUX_INITIALIZER_UNLOCKED;
+}
+
+bool ws_deque_push(ws_deque_t *dq, void *item) {
+    bool ok = false;
+    taskENTER_CRITICAL(&dq->mux);
+    if (dq->count < dq->capacity) {
+        dq->slots[(dq->head + dq->count) % dq->capacity] = item;
+        dq->count++;
+        ok = true;
+    }
+    taskEXIT_CRITICAL(&dq->mux);
+    return ok;
+}
+
+uint32_t ws_deque_pop(ws_deque_t *dq, void **items, uint32_t max) {
+    uint32_t n = 0;
+    taskENTER_CRITICAL(&dq->mux);
+    while (n < max && dq->count > 0) {
+        items[n++] = dq->slots[dq->head];
+        dq->head = (dq->head + 1) % dq->capacity;
+        dq->count--;
+    }
+    taskEXIT_CRITICAL(&dq->mux);
+    return n;
+}
+
+bool ws_deque_steal(ws_deque_t *dq, void **item) {
+    bool ok = false;
+    taskENTER_CRITICAL(&dq->mux);
+    if (dq->count > 0) {
+        dq->count--;
+        *item = dq->slots[(dq->head + dq->count) % dq->capacity];
+        ok = true;
+    }
+    taskEXIT_CRITICAL(&dq->mux);
+    return ok;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+
+/*
+ * Bounded per-consumer work deque for work stealing.
+ *
+ * Producers append at the tail, the owning consumer takes the oldest items
+ * from the head, and an idle peer steals the newest item from the tail. Any
+ * number of tasks may push or steal, so each operation is a short critical
+ * section on the deque's own spinlock (a few loads and stores, no blocking).
+ * Waking the owner is left to the caller.
+ */
+typedef struct {
+    void **slots;
+    uint32_t capacity;
+    uint32_t head;                // index of the oldest item
+    volatile uint32_t count;      // read without the lock for victim selection
+    portMUX_TYPE mux;
+} ws_deque_t;
+
+// storage must hold capacity pointers
+void ws_deque_init(ws_deque_t *dq, void **storage, uint32_t capacity);
+
+// Appends at the tail; false if the deque is full
+bool ws_deque_push(ws_deque_t *dq, void *item);
+
+// Owner side: removes up to max items from the head, oldest first; returns how many
+uint32_t ws_deque_pop(ws_deque_t *dq, void **items, uint32_t max);
+
+// Thief side: removes the newest item from the tail
+bool ws_deque_steal(ws_deque_t *dq, void **item);
+
+static inline uint32_t ws_deque_count(const ws_deque_t *dq) { return dq->count; }
@@ -8,6 +8,9 @@
 #include "esp_log.h"
 #include "driver/gpio.h"
 #include "esp_random.h"
+#include "esp_timer.h"
+#include "lab_metrics.h"
+#include "lab_alloc.h"
 
 static const char *TAG = "QUEUE_SETS";
 
@@ -17,15 +20,37 @@ static const char *TAG = "QUEUE_SETS";
 #define LED_TIMER GPIO_NUM_18
 #define LED_PROCESSOR GPIO_NUM_19
 
+// Processor dispatch:
+//   DISPATCH_SINGLE   - original: one item per xQueueSelectFromSet wake-up, then a 200 ms nap
+//   DISPATCH_WEIGHTED - drain every ready member, smooth weighted round-robin by source_weight
+//   DISPATCH_PRIORITY - drain every ready member, strict user > sensor > network > timer
+#define DISPATCH_SINGLE 0
+#define DISPATCH_WEIGHTED 1
+#define DISPATCH_PRIORITY 2
+#define DISPATCH_MODE DISPATCH_WEIGHTED
+#define ITEM_PROCESSING_MS 20    // Simulated work per item in the drain modes
+
 QueueHandle_t xSensorQueue, xUserQueue, xNetworkQueue;
 SemaphoreHandle_t xTimerSemaphore;
 QueueSetHandle_t xQueueSet;
 
-typedef struct { int sensor_id; float temperature; float humidity; uint32_t timestamp; } sensor_data_t;
-typedef struct { int button_id; bool pressed; uint32_t duration_ms; } user_input_t;
-typedef struct { char source[20]; char message[100]; int priority; } network_message_t;
-typedef struct { uint32_t sensor_count, user_count, network_count, timer_count; } message_stats_t;
-message_stats_t stats = {0,0,0,0};
+typedef struct { int sensor_id; float temperature; float humidity; uint32_t timestamp; int64_t queued_us; } sensor_data_t;
+typedef struct { int button_id; bool pressed; uint32_t duration_ms; int64_t queued_us; } user_input_t;
+typedef struct { char source[20]; char message[100]; int priority; int64_t queued_us; } network_message_t;
+typedef struct { lab_counter_t *sensor_count, *user_count, *network_count, *timer_count; } message_stats_t;
+message_stats_t stats;
+
+// Sources in strict-priority order; weights are used by DISPATCH_WEIGHTED
+typedef enum { SRC_USER = 0, SRC_SENSOR, SRC_NETWORK, SRC_TIMER, SRC_COUNT } source_t;
+static const char *source_names[SRC_COUNT] = { "User", "Sensor", "Network", "Timer" };
+static const int source_weight[SRC_COUNT] = { 4, 3, 2, 1 };
+
+typedef struct {
+    lab_histogram_t *service_us;   // enqueue -> processed
+    uint32_t backlog_peak;         // most items seen pending at once
+} source_stats_t;
+static source_stats_t source_stats[SRC_COUNT];
+static volatile int64_t timer_given_us;   // The semaphore carries no payload
 
 void sensor_task(void *p) {
     sensor_data_t data;
@@ -33,6 +58,7 @@ void sensor_task(void *p) {
     while(1) {
         data.temperature = 20.0 + (esp_random() % 200) / 10.0;
         data.humidity = 30.0 + (esp_random() % 400) / 10.0;
+        data.queued_us = esp_timer_get_time();
         if (xQueueSend(xSensorQueue, &data, 0) == pdPASS) {
             ESP_LOGI(TAG, "📊 Sensor: T=%.1f, H=%.1f", data.temperature, data.humidity);
             gpio_set_level(LED_SENSOR, 1); vTaskDelay(50); gpio_set_level(LED_SENSOR, 0);
@@ -46,6 +72,7 @@ void user_input_task(void *p) {
     ESP_LOGI(TAG, "User input task started");
     while(1) {
         input.button_id = 1 + (esp_random() % 3);
+        input.queued_us = esp_timer_get_time();
         if (xQueueSend(xUserQueue, &input, 0) == pdPASS) {
             ESP_LOGI(TAG, "🔘 User: Button %d pressed", input.button_id);
             gpio_set_level(LED_USER, 1); vTaskDelay(50); gpio_set_level(LED_USER, 0);
@@ -59,6 +86,7 @@ void network_task(void *p) {
     ESP_LOGI(TAG, "Network task started");
     while(1) {
         strcpy(msg.source, "WiFi"); strcpy(msg.message, "Status update");
+        msg.queued_us = esp_timer_get_time();
         if (xQueueSend(xNetworkQueue, &msg, 0) == pdPASS) {
             ESP_LOGI(TAG, "🌐 Network: Msg from %s", msg.source);
             gpio_set_level(LED_NETWORK, 1); vTaskDelay(50); gpio_set_level(LED_NETWORK, 0);
@@ -71,6 +99,7 @@ void timer_task(void *p) {
     ESP_LOGI(TAG, "Timer task started");
     while(1) {
         vTaskDelay(pdMS_TO_TICKS(10000));
+        timer_given_us = esp_timer_get_time();
         if (xSemaphoreGive(xTimerSemaphore) == pdPASS) {
             ESP_LOGI(TAG, "⏰ Timer: Event fired");
             gpio_set_level(LED_TIMER, 1); vTaskDelay(100); gpio_set_level(LED_TIMER, 0);
@@ -78,6 +107,110 @@ void timer_task(void *p) {
     }
 }
 
+static source_t source_of(QueueSetMemberHandle_t member) {
+    if (member == xUserQueue) return SRC_USER;
+    if (member == xSensorQueue) return SRC_SENSOR;
+    if (member == xNetworkQueue) return SRC_NETWORK;
+    return SRC_TIMER;
+}
+
+static void print_source_stats(void) {
+    for (int i = 0; i < SRC_COUNT; i++) {
+        lab_hist_summary_t svc;
+        lab_hist_summary(source_stats[i].service_us, &svc);
+        ESP_LOGI(TAG, "    %-7s backlog peak %lu | service us n=%lu p50=%lu p99=%lu max=%lu", source_names[i],
+                 (unsigned long)source_stats[i].backlog_peak, (unsigned long)svc.count, (unsigned long)svc.p50, (unsigned long)svc.p99, (unsigned long)svc.max);
+    }
+}
+
+#if DISPATCH_MODE != DISPATCH_SINGLE
+// Picks the next source to serve among those with pending items.
+static source_t pick_source(const uint32_t pending[SRC_COUNT]) {
+#if DISPATCH_MODE == DISPATCH_PRIORITY
+    for (int i = 0; i < SRC_COUNT; i++) {
+        if (pending[i]) return (source_t)i;
+    }
+    return SRC_COUNT;
+#else
+    // Smooth weighted round-robin (as in nginx): spreads each source's share evenly
+    static int current[SRC_COUNT];
+    int total = 0, best = -1;
+    for (int i = 0; i < SRC_COUNT; i++) {
+        if (!pending[i]) continue;
+        current[i] += source_weight[i];
+        total += source_weight[i];
+        if (best < 0 || current[i] > current[best]) best = i;
+    }
+    if (best < 0) return SRC_COUNT;
+    current[best] -= total;
+    return (source_t)best;
+#endif
+}
+
+// Receives and handles one item that the set has already announced for src
+static void process_one(source_t src) {
+    sensor_data_t sensor_data; user_input_t user_input; network_message_t network_msg;
+    int64_t queued_us = 0;
+    bool ok = false;
+    switch (src) {
+        case SRC_USER:
+            if ((ok = xQueueReceive(xUserQueue, &user_input, 0) == pdPASS)) {
+                lab_counter_inc(stats.user_count); queued_us = user_input.queued_us;
+                ESP_LOGI(TAG, "→ Processing USER input (button %d)", user_input.button_id);
+            }
+            break;
+        case SRC_SENSOR:
+            if ((ok = xQueueReceive(xSensorQueue, &sensor_data, 0) == pdPASS)) {
+                lab_counter_inc(stats.sensor_count); queued_us = sensor_data.queued_us;
+                ESP_LOGI(TAG, "→ Processing SENSOR data");
+            }
+            break;
+        case SRC_NETWORK:
+            if ((ok = xQueueReceive(xNetworkQueue, &network_msg, 0) == pdPASS)) {
+                lab_counter_inc(stats.network_count); queued_us = network_msg.queued_us;
+                ESP_LOGI(TAG, "→ Processing NETWORK message");
+            }
+            break;
+        default:
+            if ((ok = xSemaphoreTake(xTimerSemaphore, 0) == pdPASS)) {
+                lab_counter_inc(stats.timer_count); queued_us = timer_given_us;
+                ESP_LOGI(TAG, "→ Processing TIMER event");
+                ESP_LOGI(TAG, "--- STATS | Sensor:%lu, User:%lu, Net:%lu, Timer:%lu ---", (unsigned long)lab_counter_read(stats.sensor_count),
+                         (unsigned long)lab_counter_read(stats.user_count), (unsigned long)lab_counter_read(stats.network_count), (unsigned long)lab_counter_read(stats.timer_count));
+                print_source_stats();
+            }
+            break;
+    }
+    if (!ok) return;
+    vTaskDelay(pdMS_TO_TICKS(ITEM_PROCESSING_MS)); // Simulate processing
+    lab_hist_record(source_stats[src].service_us, (uint32_t)(esp_timer_get_time() - queued_us));
+}
+
+// Every set entry stands for exactly one item in its member, so items are only read
+// after their entry has been taken from the set. That keeps the set from overflowing
+// while the processor picks members out of arrival order.
+void processor_task(void *p) {
+    uint32_t pending[SRC_COUNT] = {0};
+    ESP_LOGI(TAG, "Processor task started (%s dispatch)", DISPATCH_MODE == DISPATCH_PRIORITY ? "priority" : "weighted-fair");
+    while(1) {
+        QueueSetMemberHandle_t member = xQueueSelectFromSet(xQueueSet, portMAX_DELAY);
+        if (member == NULL) continue;
+        pending[source_of(member)]++;
+        gpio_set_level(LED_PROCESSOR, 1);
+        while (1) {
+            while ((member = xQueueSelectFromSet(xQueueSet, 0)) != NULL) pending[source_of(member)]++;
+            for (int i = 0; i < SRC_COUNT; i++) {
+                if (pending[i] > source_stats[i].backlog_peak) source_stats[i].backlog_peak = pending[i];
+            }
+            source_t src = pick_source(pending);
+            if (src == SRC_COUNT) break;   // Idle: everything announced has been served
+            pending[src]--;
+            process_one(src);
+        }
+        gpio_set_level(LED_PROCESSOR, 0);
+    }
+}
+#else
 void processor_task(void *p) {
     QueueSetMemberHandle_t xActivatedMember;
     sensor_data_t sensor_data; user_input_t user_input; network_message_t network_msg;
@@ -85,20 +218,46 @@ void processor_task(void *p) {
     while(1) {
         xActivatedMember = xQueueSelectFromSet(xQueueSet, portMAX_DELAY);
         gpio_set_level(LED_PROCESSOR, 1);
+        int64_t queued_us = -1;
         if (xActivatedMember == xSensorQueue && xQueueReceive(xSensorQueue, &sensor_data, 0) == pdPASS) {
-            stats.sensor_count++; ESP_LOGI(TAG, "→ Processing SENSOR data");
+            lab_counter_inc(stats.sensor_count); queued_us = sensor_data.queued_us; ESP_LOGI(TAG, "→ Processing SENSOR data");
         } else if (xActivatedMember == xUserQueue && xQueueReceive(xUserQueue, &user_input, 0) == pdPASS) {
-            stats.user_count++; ESP_LOGI(TAG, "→ Processing USER input");
+            lab_counter_inc(stats.user_count); queued_us = user_input.queued_us; ESP_LOGI(TAG, "→ Processing USER input");
         } else if (xActivatedMember == xNetworkQueue && xQueueReceive(xNetworkQueue, &network_msg, 0) == pdPASS) {
-            stats.network_count++; ESP_LOGI(TAG, "→ Processing NETWORK message");
+            lab_counter_inc(stats.network_count); queued_us = network_msg.queued_us; ESP_LOGI(TAG, "→ Processing NETWORK message");
         } else if (xActivatedMember == xTimerSemaphore && xSemaphoreTake(xTimerSemaphore, 0) == pdPASS) {
-            stats.timer_count++; ESP_LOGI(TAG, "→ Processing TIMER event");
-            ESP_LOGI(TAG, "--- STATS | Sensor:%lu, User:%lu, Net:%lu, Timer:%lu ---", stats.sensor_count, stats.user_count, stats.network_count, stats.timer_count);
+            lab_counter_inc(stats.timer_count); queued_us = timer_given_us; ESP_LOGI(TAG, "→ Processing TIMER event");
+            ESP_LOGI(TAG, "--- STATS | Sensor:%lu, User:%lu, Net:%lu, Timer:%lu ---", lab_counter_read(stats.sensor_count),
+                     lab_counter_read(stats.user_count), lab_counter_read(stats.network_count), lab_counter_read(stats.timer_count));
+            print_source_stats();
         }
         vTaskDelay(pdMS_TO_TICKS(200)); // Simulate processing
+        if (queued_us >= 0) {
+            source_t src = source_of(xActivatedMember);
+            UBaseType_t waiting = src == SRC_TIMER ? uxSemaphoreGetCount(xTimerSemaphore) : uxQueueMessagesWaiting((QueueHandle_t)xActivatedMember);
+            if (waiting > source_stats[src].backlog_peak) source_stats[src].backlog_peak = waiting;
+            lab_hist_record(source_stats[src].service_us, (uint32_t)(esp_timer_get_time() - queued_us));
+        }
         gpio_set_level(LED_PROCESSOR, 0);
     }
 }
+#endif
+
+// The queue set itself has no static variant and is created separately
+static const lab_object_def_t lab_objects[] = {
+    LAB_QUEUE(&xSensorQueue, 5, sizeof(sensor_data_t)),
+    LAB_QUEUE(&xUserQueue, 3, sizeof(user_input_t)),
+    LAB_QUEUE(&xNetworkQueue, 8, sizeof(network_message_t)),
+    LAB_BINARY_SEMAPHORE(&xTimerSemaphore),
+};
+
+static const lab_task_def_t lab_tasks[] = {
+    LAB_TASK(sensor_task, "Sensor", 2048, NULL, 3, NULL),
+    LAB_TASK(user_input_task, "UserInput", 2048, NULL, 3, NULL),
+    LAB_TASK(network_task, "Network", 2048, NULL, 3, NULL),
+    LAB_TASK(timer_task, "Timer", 2048, NULL, 2, NULL),
+    LAB_TASK(processor_task, "Processor", 3072, NULL, 4, NULL),
+};
 
 void app_main(void) {
     ESP_LOGI(TAG, "Queue Sets Lab Starting...");
@@ -106,23 +265,29 @@ void app_main(void) {
     io_conf.pin_bit_mask = (1ULL<<LED_SENSOR)|(1ULL<<LED_USER)|(1ULL<<LED_NETWORK)|(1ULL<<LED_TIMER)|(1ULL<<LED_PROCESSOR);
     gpio_config(&io_conf);
 
-    xSensorQueue = xQueueCreate(5, sizeof(sensor_data_t));
-    xUserQueue = xQueueCreate(3, sizeof(user_input_t));
-    xNetworkQueue = xQueueCreate(8, sizeof(network_message_t));
-    xTimerSemaphore = xSemaphoreCreateBinary();
+    bool objects_ready = lab_objects_create(lab_objects, LAB_ARRAY_SIZE(lab_objects));
     xQueueSet = xQueueCreateSet(5 + 3 + 8 + 1);
+    stats.sensor_count = lab_counter("sensor");
+    stats.user_count = lab_counter("user");
+    stats.network_count = lab_counter("network");
+    stats.timer_count = lab_counter("timer");
+    bool source_stats_ok = true;
+    for (int i = 0; i < SRC_COUNT; i++) {
+        char name[LAB_METRICS_NAME_LEN];
+        snprintf(name, sizeof(name), "svc_%s_us", source_names[i]);
+        source_stats[i].service_us = lab_histogram(name);
+        source_stats_ok = source_stats_ok && source_stats[i].service_us;
+    }
 
-    if (xQueueSet && xQueueAddToSet(xSensorQueue, xQueueSet) == pdPASS &&
+    if (objects_ready && xQueueSet && stats.sensor_count && stats.user_count && stats.network_count && stats.timer_count && source_stats_ok &&
+        xQueueAddToSet(xSensorQueue, xQueueSet) == pdPASS &&
         xQueueAddToSet(xUserQueue, xQueueSet) == pdPASS &&
         xQueueAddToSet(xNetworkQueue, xQueueSet) == pdPASS &&
         xQueueAddToSet(xTimerSemaphore, xQueueSet) == pdPASS) {
         
         ESP_LOGI(TAG, "Queue set created successfully");
-        xTaskCreate(sensor_task, "Sensor", 2048, NULL, 3, NULL);
-        xTaskCreate(user_input_task, "UserInput", 2048, NULL, 3, NULL);
-        xTaskCreate(network_task, "Network", 2048, NULL, 3, NULL);
-        xTaskCreate(timer_task, "Timer", 2048, NULL, 2, NULL);
-        xTaskCreate(processor_task, "Processor", 3072, NULL, 4, NULL);
+        lab_tasks_create(lab_tasks, LAB_ARRAY_SIZE(lab_tasks));
+        lab_alloc_report(TAG);
     } else {
         ESP_LOGE(TAG, "Failed to create or configure queue set!");
     }
@@ -6,6 +6,9 @@
 #include "driver/gpio.h"
 #include "driver/gptimer.h"
 #include "esp_random.h"
+#include "esp_timer.h"
+#include "lab_metrics.h"
+#include "lab_alloc.h"
 
 static const char *TAG = "BINARY_SEM";
 
@@ -14,30 +17,150 @@ static const char *TAG = "BINARY_SEM";
 #define LED_TIMER GPIO_NUM_5
 #define BUTTON_PIN GPIO_NUM_0
 
-SemaphoreHandle_t xBinarySemaphore, xTimerSemaphore, xButtonSemaphore;
+// ISR -> task signaling for the timer and button events:
+//   1 = direct-to-task notifications (value counts events, so bursts are not lost)
+//   0 = dedicated binary semaphores (a second give before the take is dropped)
+#define USE_TASK_NOTIFY 1
+#define RUN_WAKE_BENCHMARK 1     // Compare ISR -> task wake latency of both mechanisms at startup
+#define WAKE_BENCH_SAMPLES 1000
+#define WAKE_BENCH_PERIOD_US 2000
+#define WAKE_BENCH_TIMEOUT_MS 100   // give up if the alarm stops arriving
+
+SemaphoreHandle_t xBinarySemaphore, xTimerSemaphore, xButtonSemaphore;   // ISR semaphores stay NULL with USE_TASK_NOTIFY
+TaskHandle_t xTimerEventTask = NULL, xButtonEventTask = NULL;
 gptimer_handle_t gptimer = NULL;
-typedef struct { uint32_t sent, received, timer, button; } stats_t;
-stats_t stats = {0,0,0,0};
+typedef struct { lab_counter_t *sent, *received, *timer, *button, *coalesced; } stats_t;
+stats_t stats;
 
 static bool IRAM_ATTR timer_callback(gptimer_handle_t t, const gptimer_alarm_event_data_t *e, void *u) {
     BaseType_t woken = pdFALSE;
+#if USE_TASK_NOTIFY
+    vTaskNotifyGiveFromISR(xTimerEventTask, &woken);
+#else
     xSemaphoreGiveFromISR(xTimerSemaphore, &woken);
+#endif
     return woken == pdTRUE;
 }
 
 static void IRAM_ATTR button_isr_handler(void* arg) {
     BaseType_t woken = pdFALSE;
+#if USE_TASK_NOTIFY
+    vTaskNotifyGiveFromISR(xButtonEventTask, &woken);
+#else
     xSemaphoreGiveFromISR(xButtonSemaphore, &woken);
+#endif
     portYIELD_FROM_ISR(woken);
 }
 
+// Blocks until the ISR signals; returns how many events arrived since the last wait
+static uint32_t wait_isr_event(SemaphoreHandle_t sem) {
+#if USE_TASK_NOTIFY
+    (void)sem;
+    return ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+#else
+    return xSemaphoreTake(sem, portMAX_DELAY) == pdTRUE ? 1 : 0;
+#endif
+}
+
+#if RUN_WAKE_BENCHMARK
+// A periodic gptimer alarm stamps the time and signals app_main, which runs at high
+// priority for the duration and measures how long it took to be woken.
+typedef struct {
+    volatile int64_t fired_us;
+    SemaphoreHandle_t sem;        // NULL -> notify instead
+    TaskHandle_t waiter;
+} wake_bench_t;
+
+static bool IRAM_ATTR wake_bench_callback(gptimer_handle_t t, const gptimer_alarm_event_data_t *e, void *u) {
+    wake_bench_t *b = (wake_bench_t *)u;
+    BaseType_t woken = pdFALSE;
+    b->fired_us = esp_timer_get_time();
+    if (b->sem) xSemaphoreGiveFromISR(b->sem, &woken);
+    else vTaskNotifyGiveFromISR(b->waiter, &woken);
+    return woken == pdTRUE;
+}
+
+// Returns false (histogram incomplete) if the timer could not be set up or stopped firing
+static bool wake_bench_run(wake_bench_t *b, lab_histogram_t *h) {
+    gptimer_handle_t timer = NULL;
+    gptimer_config_t timer_config = { .clk_src = GPTIMER_CLK_SRC_DEFAULT, .direction = GPTIMER_COUNT_UP, .resolution_hz = 1000000 };
+    esp_err_t err = gptimer_new_timer(&timer_config, &timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Wake benchmark: no free timer (%s), skipping", esp_err_to_name(err));
+        return false;
+    }
+    gptimer_event_callbacks_t cbs = { .on_alarm = wake_bench_callback };
+    gptimer_alarm_config_t alarm_config = { .alarm_count = WAKE_BENCH_PERIOD_US, .flags.auto_reload_on_alarm = true };
+    err = gptimer_register_event_callbacks(timer, &cbs, b);
+    if (err == ESP_OK) err = gptimer_set_alarm_action(timer, &alarm_config);
+    if (err == ESP_OK) err = gptimer_enable(timer);
+    if (err == ESP_OK) {
+        err = gptimer_start(timer);
+        if (err != ESP_OK) gptimer_disable(timer);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Wake benchmark: timer setup failed (%s), skipping", esp_err_to_name(err));
+        gptimer_del_timer(timer);
+        return false;
+    }
+
+    TickType_t timeout = pdMS_TO_TICKS(WAKE_BENCH_TIMEOUT_MS);
+    int samples = 0;
+    for (; samples < WAKE_BENCH_SAMPLES; samples++) {
+        bool woken = b->sem ? xSemaphoreTake(b->sem, timeout) == pdTRUE : ulTaskNotifyTake(pdTRUE, timeout) > 0;
+        if (!woken) break;
+        lab_hist_record(h, (uint32_t)(esp_timer_get_time() - b->fired_us));
+    }
+
+    gptimer_stop(timer);
+    gptimer_disable(timer);
+    gptimer_del_timer(timer);
+    if (!b->sem) ulTaskNotifyTake(pdTRUE, 0); // Drop a give that raced the stop
+    if (samples < WAKE_BENCH_SAMPLES) {
+        ESP_LOGE(TAG, "Wake benchmark: no alarm for %d ms after %d samples, skipping", WAKE_BENCH_TIMEOUT_MS, samples);
+        return false;
+    }
+    return true;
+}
+
+static void wake_benchmark(void) {
+    lab_histogram_t *h_sem = lab_histogram("wake_sem_us"), *h_ntf = lab_histogram("wake_notify_us");
+    wake_bench_t b = { .waiter = xTaskGetCurrentTaskHandle() };
+    b.sem = xSemaphoreCreateBinary();
+    if (!h_sem || !h_ntf || !b.sem) {
+        ESP_LOGE(TAG, "Wake benchmark: allocation failed");
+        if (b.sem) vSemaphoreDelete(b.sem);
+        return;
+    }
+
+    UBaseType_t prio = uxTaskPriorityGet(NULL);
+    vTaskPrioritySet(NULL, configMAX_PRIORITIES - 2);
+    bool ok = wake_bench_run(&b, h_sem);
+    vSemaphoreDelete(b.sem);
+    b.sem = NULL;
+    if (ok) ok = wake_bench_run(&b, h_ntf);
+    vTaskPrioritySet(NULL, prio);
+    if (!ok) return;
+
+    const char *names[2] = { "Binary semaphore", "Task notification" };
+    lab_histogram_t *hists[2] = { h_sem, h_ntf };
+    ESP_LOGI(TAG, "📈 ISR -> task wake latency (%d samples, us):", WAKE_BENCH_SAMPLES);
+    for (int i = 0; i < 2; i++) {
+        lab_hist_summary_t sum;
+        lab_hist_summary(hists[i], &sum);
+        ESP_LOGI(TAG, "  %-17s min %lu | mean %lu | p50 %lu | p99 %lu | max %lu",
+                 names[i], (unsigned long)sum.min, (unsigned long)sum.mean, (unsigned long)sum.p50, (unsigned long)sum.p99, (unsigned long)sum.max);
+    }
+}
+#endif
+
 void producer_task(void *p) {
     ESP_LOGI(TAG, "Producer task started");
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(2000 + (esp_random() % 3000)));
         ESP_LOGI(TAG, "🔥 Producer: Generating event");
         if (xSemaphoreGive(xBinarySemaphore) == pdTRUE) {
-            stats.sent++;
+            lab_counter_inc(stats.sent);
             gpio_set_level(LED_PRODUCER, 1); vTaskDelay(100); gpio_set_level(LED_PRODUCER, 0);
         } else {
             ESP_LOGW(TAG, "✗ Producer: Failed to signal (semaphore already given?)");
@@ -50,7 +173,7 @@ void consumer_task(void *p) {
     while (1) {
         ESP_LOGI(TAG, "🔍 Consumer: Waiting for event...");
         if (xSemaphoreTake(xBinarySemaphore, pdMS_TO_TICKS(10000)) == pdTRUE) {
-            stats.received++;
+            lab_counter_inc(stats.received);
             ESP_LOGI(TAG, "⚡ Consumer: Event received! Processing...");
             gpio_set_level(LED_CONSUMER, 1);
             vTaskDelay(pdMS_TO_TICKS(1000 + (esp_random() % 2000)));
@@ -64,12 +187,16 @@ void consumer_task(void *p) {
 void timer_event_task(void *p) {
     ESP_LOGI(TAG, "Timer event task started");
     while (1) {
-        if (xSemaphoreTake(xTimerSemaphore, portMAX_DELAY) == pdTRUE) {
-            stats.timer++;
-            ESP_LOGI(TAG, "⏱️ Timer: Periodic event #%lu", stats.timer);
+        uint32_t events = wait_isr_event(xTimerSemaphore);
+        if (events) {
+            lab_counter_add(stats.timer, events);
+            if (events > 1) lab_counter_add(stats.coalesced, events - 1);
+            uint32_t timer_events = lab_counter_read(stats.timer);
+            ESP_LOGI(TAG, "⏱️ Timer: Periodic event #%lu", (unsigned long)timer_events);
             gpio_set_level(LED_TIMER, 1); vTaskDelay(200); gpio_set_level(LED_TIMER, 0);
-            if (stats.timer % 5 == 0) {
-                ESP_LOGI(TAG, "📊 Stats | Sent:%lu, Rcvd:%lu, Timer:%lu, Btn:%lu", stats.sent, stats.received, stats.timer, stats.button);
+            if (timer_events % 5 < events) {
+                ESP_LOGI(TAG, "📊 Stats | Sent:%lu, Rcvd:%lu, Timer:%lu, Btn:%lu, Coalesced:%lu", (unsigned long)lab_counter_read(stats.sent),
+                         (unsigned long)lab_counter_read(stats.received), (unsigned long)timer_events, (unsigned long)lab_counter_read(stats.button), (unsigned long)lab_counter_read(stats.coalesced));
             }
         }
     }
@@ -78,16 +205,35 @@ void timer_event_task(void *p) {
 void button_event_task(void *p) {
     ESP_LOGI(TAG, "Button event task started");
     while (1) {
-        if (xSemaphoreTake(xButtonSemaphore, portMAX_DELAY) == pdTRUE) {
-            stats.button++;
-            ESP_LOGI(TAG, "🔘 Button: Press #%lu", stats.button);
+        uint32_t events = wait_isr_event(xButtonSemaphore);
+        if (events) {
+            lab_counter_inc(stats.button);   // Edges within one wake-up are bounce of the same press
+            ESP_LOGI(TAG, "🔘 Button: Press #%lu", (unsigned long)lab_counter_read(stats.button));
             vTaskDelay(pdMS_TO_TICKS(300)); // Debounce
+#if USE_TASK_NOTIFY
+            ulTaskNotifyTake(pdTRUE, 0);     // Discard bounce edges counted while waiting
+#endif
             ESP_LOGI(TAG, "🚀 Button: Triggering immediate event");
-            if(xSemaphoreGive(xBinarySemaphore) == pdTRUE) stats.sent++;
+            if(xSemaphoreGive(xBinarySemaphore) == pdTRUE) lab_counter_inc(stats.sent);
         }
     }
 }
 
+static const lab_object_def_t lab_objects[] = {
+    LAB_BINARY_SEMAPHORE(&xBinarySemaphore),
+#if !USE_TASK_NOTIFY
+    LAB_BINARY_SEMAPHORE(&xTimerSemaphore),
+    LAB_BINARY_SEMAPHORE(&xButtonSemaphore),
+#endif
+};
+
+static const lab_task_def_t lab_tasks[] = {
+    LAB_TASK(producer_task, "Producer", 2048, NULL, 3, NULL),
+    LAB_TASK(consumer_task, "Consumer", 2048, NULL, 2, NULL),
+    LAB_TASK(timer_event_task, "TimerEvent", 2048, NULL, 4, &xTimerEventTask),
+    LAB_TASK(button_event_task, "ButtonEvent", 2048, NULL, 5, &xButtonEventTask),
+};
+
 void app_main(void) {
     ESP_LOGI(TAG, "Binary Semaphores Lab Starting...");
 
@@ -96,12 +242,24 @@ void app_main(void) {
     gpio_config_t btn_conf = { .mode = GPIO_MODE_INPUT, .pull_up_en = GPIO_PULLUP_ENABLE, .intr_type = GPIO_INTR_NEGEDGE, .pin_bit_mask = (1ULL<<BUTTON_PIN) };
     gpio_config(&btn_conf);
 
-    xBinarySemaphore = xSemaphoreCreateBinary();
-    xTimerSemaphore = xSemaphoreCreateBinary();
-    xButtonSemaphore = xSemaphoreCreateBinary();
+#if RUN_WAKE_BENCHMARK
+    wake_benchmark();
+#endif
+
+    bool objects_ready = lab_objects_create(lab_objects, LAB_ARRAY_SIZE(lab_objects));
+    stats.sent = lab_counter("sent");
+    stats.received = lab_counter("received");
+    stats.timer = lab_counter("timer");
+    stats.button = lab_counter("button");
+    stats.coalesced = lab_counter("coalesced");
+
+    if (objects_ready &&
+        stats.sent && stats.received && stats.timer && stats.button && stats.coalesced) {
+        ESP_LOGI(TAG, "Semaphores created (ISR signaling: %s)", USE_TASK_NOTIFY ? "task notifications" : "binary semaphores");
+        // The ISRs notify these tasks directly, so they must exist before the ISRs are armed
+        lab_tasks_create(lab_tasks, LAB_ARRAY_SIZE(lab_tasks));
+        lab_alloc_report(TAG);
 
-    if (xBinarySemaphore && xTimerSemaphore && xButtonSemaphore) {
-        ESP_LOGI(TAG, "Semaphores created");
         gpio_install_isr_service(0);
         gpio_isr_handler_add(BUTTON_PIN, button_isr_handler, NULL);
 
@@ -113,11 +271,6 @@ void app_main(void) {
         gptimer_alarm_config_t alarm_config = { .alarm_count = 8000000, .flags.auto_reload_on_alarm = true };
         gptimer_set_alarm_action(gptimer, &alarm_config);
         gptimer_start(gptimer);
-
-        xTaskCreate(producer_task, "Producer", 2048, NULL, 3, NULL);
-        xTaskCreate(consumer_task, "Consumer", 2048, NULL, 2, NULL);
-        xTaskCreate(timer_event_task, "TimerEvent", 2048, NULL, 4, NULL);
-        xTaskCreate(button_event_task, "ButtonEvent", 2048, NULL, 5, NULL);
     } else {
         ESP_LOGE(TAG, "Failed to create semaphores!");
     }
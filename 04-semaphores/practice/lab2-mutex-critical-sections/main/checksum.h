@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Checksums for the shared resource, selectable at compile time with
+ * CHECKSUM_ALGO (all three are always built so the benchmark can compare them):
+ *
+ *   CHECKSUM_ALGO_LEGACY - the lab's original sum of byte * position, one byte per step
+ *   CHECKSUM_ALGO_WORD   - Fletcher-style sums over 32-bit words, four bytes per step
+ *   CHECKSUM_ALGO_CRC32  - table-driven CRC-32 (IEEE 802.3), one table lookup per byte
+ *
+ * The init/update/final API is incremental: data can be fed in pieces as it is
+ * produced and gives the same result as one checksum_compute() over the whole.
+ * checksum_combine() folds a separately kept field (the counter) into a data
+ * digest, so changing that field never requires re-hashing the buffer.
+ */
+
+#define CHECKSUM_ALGO_LEGACY 0
+#define CHECKSUM_ALGO_WORD   1
+#define CHECKSUM_ALGO_CRC32  2
+#define CHECKSUM_ALGO_COUNT  3
+
+#ifndef CHECKSUM_ALGO
+#define CHECKSUM_ALGO CHECKSUM_ALGO_CRC32
+#endif
+
+typedef struct {
+    uint8_t algo;
+    uint8_t tail_len;        // WORD: bytes waiting for a full word
+    uint8_t tail[4];
+    uint32_t a, b;           // running state (meaning depends on algo)
+    uint32_t pos;            // bytes consumed so far
+} checksum_ctx_t;
+
+void checksum_init_algo(checksum_ctx_t *ctx, int algo);
+void checksum_update(checksum_ctx_t *ctx, const void *data, size_t len);
+uint32_t checksum_final(const checksum_ctx_t *ctx);
+
+uint32_t checksum_compute_algo(int algo, const void *data, size_t len);
+uint32_t checksum_combine_algo(int algo, uint32_t digest, uint32_t counter);
+const char *checksum_algo_name(int algo);
+
+static inline void checksum_init(checksum_ctx_t *ctx) { checksum_init_algo(ctx, CHECKSUM_ALGO); }
+static inline uint32_t checksum_compute(const void *data, size_t len) { return checksum_compute_algo(CHECKSUM_ALGO, data, len); }
+static inline uint32_t checksum_combine(uint32_t digest, uint32_t counter) { return checksum_combine_algo(CHECKSUM_ALGO, digest, counter); }
@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lab_metrics.h"
+#include "lock_prof.h"
+
+typedef struct {
+    TaskHandle_t task;
+    uint32_t acquisitions;
+    uint32_t contended;
+    lab_histogram_t *wait_us;
+    lab_histogram_t *hold_us;
+} lock_prof_task_t;
+
+struct lock_prof {
+    char name[16];
+    SemaphoreHandle_t mutex;
+    lab_histogram_t *wait_us;
+    lab_histogram_t *hold_us;
+    lab_counter_t *timeouts;
+    uint32_t acquisitions;
+    uint32_t contended;
+    lock_prof_task_t tasks[LOCK_PROF_MAX_TASKS];
+
+    // Current holder; written by the holder, read racily by waiters on entry
+    volatile UBaseType_t holder_priority;
+    int64_t hold_start_us;
+    lock_prof_task_t *holder_row;
+
+    // Longest wait behind a lower-priority holder (the holder seen on entry)
+    uint32_t low_holder_wait_max_us;
+    char low_holder_waiter[configMAX_TASK_NAME_LEN];
+    char low_holder_name[configMAX_TASK_NAME_LEN];
+};
+
+static lock_prof_t locks[LOCK_PROF_MAX_LOCKS];
+static int lock_count = 0;
+static portMUX_TYPE lock_table_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static lab_histogram_t *named_histogram(const char *lock, const char *who, const char *what) {
+    char name[LAB_METRICS_NAME_LEN];
+    snprintf(name, sizeof(name), "%s.%s.%s", lock, who, what);
+    return lab_histogram(name);
+}
+
+lock_prof_t *lock_prof_create(const char *name, SemaphoreHandle_t mutex) {
+    lock_prof_t *lock = NULL;
+    taskENTER_CRITICAL(&lock_table_mux);
+    if (lock_count < LOCK_PROF_MAX_LOCKS) lock = &locks[lock_count++];
+    taskEXIT_CRITICAL(&lock_table_mux);
+    if (!lock) return NULL;
+
+    strncpy(lock->name, name, sizeof(lock->name) - 1);
+    lock->mutex = mutex;
+    lock->wait_us = named_histogram(name, "all", "wait");
+    lock->hold_us = named_histogram(name, "all", "hold");
+    char counter_name[LAB_METRICS_NAME_LEN];
+    snprintf(counter_name, sizeof(counter_name), "%s.timeouts", name);
+    lock->timeouts = lab_counter(counter_name);
+    return (lock->wait_us && lock->hold_us && lock->timeouts) ? lock : NULL;
+}
+
+// Called with the mutex held
+static lock_prof_task_t *task_row(lock_prof_t *lock, TaskHandle_t task) {
+    for (int i = 0; i < LOCK_PROF_MAX_TASKS; i++) {
+        lock_prof_task_t *row = &lock->tasks[i];
+        if (row->task == task) return row;
+        if (row->task == NULL) {
+            const char *task_name = pcTaskGetName(task);
+            row->wait_us = named_histogram(lock->name, task_name, "wait");
+            row->hold_us = named_histogram(lock->name, task_name, "hold");
+            if (!row->wait_us || !row->hold_us) return NULL;
+            row->task = task;
+            return row;
+        }
+    }
+    return NULL;
+}
+
+BaseType_t lock_prof_take(lock_prof_t *lock, TickType_t timeout) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    UBaseType_t my_priority = uxTaskPriorityGet(NULL);
+    TaskHandle_t holder = xSemaphoreGetMutexHolder(lock->mutex);
+    UBaseType_t holder_priority = lock->holder_priority;
+    char holder_name[configMAX_TASK_NAME_LEN] = "";
+    if (holder) strncpy(holder_name, pcTaskGetName(holder), sizeof(holder_name) - 1);
+
+    int64_t start_us = esp_timer_get_time();
+    if (xSemaphoreTake(lock->mutex, timeout) != pdTRUE) {
+        lab_counter_inc(lock->timeouts);
+        return pdFALSE;
+    }
+    uint32_t wait_us = (uint32_t)(esp_timer_get_time() - start_us);
+
+    lock->acquisitions++;
+    lab_hist_record(lock->wait_us, wait_us);
+    if (holder) {
+        lock->contended++;
+        if (holder_priority < my_priority && wait_us > lock->low_holder_wait_max_us) {
+            lock->low_holder_wait_max_us = wait_us;
+            strncpy(lock->low_holder_waiter, pcTaskGetName(self), sizeof(lock->low_holder_waiter) - 1);
+            strncpy(lock->low_holder_name, holder_name, sizeof(lock->low_holder_name) - 1);
+        }
+    }
+    lock_prof_task_t *row = task_row(lock, self);
+    if (row) {
+        row->acquisitions++;
+        if (holder) row->contended++;
+        lab_hist_record(row->wait_us, wait_us);
+    }
+
+    // Taken before any inheritance can raise it
+    lock->holder_priority = my_priority;
+    lock->holder_row = row;
+    lock->hold_start_us = esp_timer_get_time();
+    return pdTRUE;
+}
+
+void lock_prof_give(lock_prof_t *lock) {
+    uint32_t hold_us = (uint32_t)(esp_timer_get_time() - lock->hold_start_us);
+    lab_hist_record(lock->hold_us, hold_us);
+    if (lock->holder_row) lab_hist_record(lock->holder_row->hold_us, hold_us);
+    lock->holder_row = NULL;
+    xSemaphoreGive(lock->mutex);
+}
+
+static void print_row(const char *tag, const char *who, uint32_t acquisitions, uint32_t contended,
+                      lab_histogram_t *wait, lab_histogram_t *hold) {
+    lab_hist_summary_t w, h;
+    lab_hist_summary(wait, &w);
+    lab_hist_summary(hold, &h);
+    uint32_t contention_pct = acquisitions ? contended * 100 / acquisitions : 0;
+    ESP_LOGI(tag, "  %-10s %6lu %5lu%% | wait p50 %7lu p99 %7lu max %7lu | hold p50 %7lu p99 %7lu max %7lu",
+             who, (unsigned long)acquisitions, (unsigned long)contention_pct, (unsigned long)w.p50, (unsigned long)w.p99, (unsigned long)w.max, (unsigned long)h.p50, (unsigned long)h.p99, (unsigned long)h.max);
+}
+
+void lock_prof_print(const char *tag) {
+    for (int i = 0; i < lock_count; i++) {
+        lock_prof_t *lock = &locks[i];
+        ESP_LOGI(tag, "🔒 Lock %s | timeouts %lu | longest wait behind lower-prio holder %lu us (%s behind %s)", lock->name,
+                 (unsigned long)lab_counter_read(lock->timeouts), (unsigned long)lock->low_holder_wait_max_us,
+                 lock->low_holder_wait_max_us ? lock->low_holder_waiter : "-", lock->low_holder_wait_max_us ? lock->low_holder_name : "-");
+        ESP_LOGI(tag, "  %-10s %6s %6s | %-38s | %s", "task", "acq", "cont", "wait (us)", "hold (us)");
+        for (int t = 0; t < LOCK_PROF_MAX_TASKS && lock->tasks[t].task; t++) {
+            lock_prof_task_t *row = &lock->tasks[t];
+            print_row(tag, pcTaskGetName(row->task), row->acquisitions, row->contended, row->wait_us, row->hold_us);
+        }
+        print_row(tag, "(all)", lock->acquisitions, lock->contended, lock->wait_us, lock->hold_us);
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+/*
+ * Profiling wrapper around a FreeRTOS mutex.
+ *
+ * lock_prof_take()/lock_prof_give() behave like xSemaphoreTake()/xSemaphoreGive()
+ * and additionally record, per lock and per calling task, how long the caller
+ * waited and how long it held the lock (lab_metrics histograms, microseconds).
+ *
+ * A take is "contended" when the mutex already had a holder on entry. When that
+ * holder's priority (as it took the lock) was below the waiter's, the wait is a
+ * "wait behind a lower-priority holder"; the longest one is kept together with
+ * the two task names. Only the holder seen on entry is attributed: if the lock
+ * passes through other tasks before the waiter gets it, their holds are part of
+ * the same wait, so this is an upper bound on the inversion, not its exact length.
+ *
+ * All bookkeeping except timeouts is done while the mutex is held, so the lock
+ * itself serializes it. Per-task rows are created on a task's first take.
+ */
+
+#define LOCK_PROF_MAX_LOCKS   4
+#define LOCK_PROF_MAX_TASKS   6     // rows per lock; further tasks only count in the lock total
+
+typedef struct lock_prof lock_prof_t;
+
+// Wraps an existing mutex. NULL when the lock table or the metrics registry is full.
+lock_prof_t *lock_prof_create(const char *name, SemaphoreHandle_t mutex);
+
+BaseType_t lock_prof_take(lock_prof_t *lock, TickType_t timeout);
+void lock_prof_give(lock_prof_t *lock);
+
+// Logs the contention table for every profiled lock
+void lock_prof_print(const char *tag);
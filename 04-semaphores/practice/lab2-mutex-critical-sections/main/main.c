@@ -7,6 +7,13 @@
 #include "esp_log.h"
 #include "driver/gpio.h"
 #include "esp_random.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "lab_metrics.h"
+#include "lock_prof.h"
+#include "seqlock.h"
+#include "checksum.h"
+#include "lab_alloc.h"
 
 static const char *TAG = "MUTEX_LAB";
 
@@ -15,25 +22,97 @@ static const char *TAG = "MUTEX_LAB";
 #define LED_TASK3 GPIO_NUM_5
 #define LED_CRITICAL GPIO_NUM_18
 
+// How HIGH/MED/LOW update shared_data:
+//   0 = pessimistic: hold xMutex across the whole read-work-write (original)
+//   1 = optimistic: versioned snapshot, work without any lock, CAS commit on the version, retry on conflict
+#define USE_OPTIMISTIC_UPDATES 0
+#define OPTIMISTIC_MAX_ATTEMPTS 5
+#define RUN_SEQLOCK_BENCHMARK 1      // Reader latency (seqlock vs mutex) under writer load at startup
+#define RUN_CHECKSUM_BENCHMARK 1     // Cycles per byte of each CHECKSUM_ALGO_* at startup
+#define SEQLOCK_BENCH_READS 300
+
 SemaphoreHandle_t xMutex;
+lock_prof_t *xMutexProf;   // Profiled view of xMutex; all takes/gives go through it
 
 typedef struct { uint32_t counter; char shared_buffer[100]; uint32_t checksum; uint32_t access_count; } shared_resource_t;
 shared_resource_t shared_data = {0, "", 0, 0};
+seqlock_t shared_seq = SEQLOCK_INIT;   // Writers (holding xMutex) bump it so readers can snapshot without the mutex
+
+typedef struct { lab_counter_t *successful_access, *failed_access, *corruption_detected; } access_stats_t;
+access_stats_t stats;
+
+// Per access task (task_id 1..3): committed updates, optimistic conflicts, request -> committed latency
+#define ACCESS_TASKS 3
+typedef struct { const char *name; lab_counter_t *commits, *conflicts; lab_histogram_t *latency_ms; } task_access_stats_t;
+task_access_stats_t task_stats[ACCESS_TASKS] = { { "HIGH_PRI" }, { "MED_PRI" }, { "LOW_PRI" } };
+int64_t lab_start_us;
 
-typedef struct { uint32_t successful_access; uint32_t failed_access; uint32_t corruption_detected; } access_stats_t;
-access_stats_t stats = {0, 0, 0};
+// Digest of the buffer (CHECKSUM_ALGO, see checksum.h) combined with the counter
+uint32_t calculate_checksum_len(const char* data, size_t len, uint32_t counter) {
+    return checksum_combine(checksum_compute(data, len), counter);
+}
 
 uint32_t calculate_checksum(const char* data, uint32_t counter) {
-    uint32_t sum = counter;
-    for (int i = 0; data[i] != '\0'; i++) { sum += (uint32_t)data[i] * (i + 1); }
-    return sum;
+    return calculate_checksum_len(data, strnlen(data, sizeof(shared_data.shared_buffer)), counter);
+}
+
+// Writes the "last modifier" text; returns its length so writers don't need strlen()
+static size_t format_modifier(char *buffer, const char *task_name, uint32_t counter) {
+    int n = snprintf(buffer, sizeof(shared_data.shared_buffer), "Modified by %s #%lu", task_name, (unsigned long)counter);
+    return n < (int)sizeof(shared_data.shared_buffer) ? (size_t)n : sizeof(shared_data.shared_buffer) - 1;
 }
 
+static void record_commit(int task_id, int64_t start_us) {
+    task_access_stats_t *ts = &task_stats[task_id - 1];
+    lab_counter_inc(ts->commits);
+    lab_hist_record(ts->latency_ms, (uint32_t)((esp_timer_get_time() - start_us) / 1000));
+}
+
+#if USE_OPTIMISTIC_UPDATES
 void access_shared_resource(int task_id, const char* task_name, gpio_num_t led_pin) {
+    int64_t start_us = esp_timer_get_time();
+    gpio_set_level(led_pin, 1);
+    for (int attempt = 1; attempt <= OPTIMISTIC_MAX_ATTEMPTS; attempt++) {
+        shared_resource_t snap, next;
+        uint32_t version = seqlock_read_versioned(&shared_seq, &snap, &shared_data, sizeof(snap), NULL);
+        ESP_LOGI(TAG, "[%s] Snapshot v%lu (attempt %d)", task_name, version, attempt);
+
+        // Work on the private copy; other tasks keep running meanwhile
+        if (calculate_checksum(snap.shared_buffer, snap.counter) != snap.checksum && snap.access_count > 0) {
+            ESP_LOGE(TAG, "[%s] ⚠️ DATA CORRUPTION DETECTED!", task_name);
+            lab_counter_inc(stats.corruption_detected);
+        }
+        vTaskDelay(pdMS_TO_TICKS(500 + (esp_random() % 1000)));
+        next.counter = snap.counter + 1;
+        size_t len = format_modifier(next.shared_buffer, task_name, next.counter);
+        next.checksum = calculate_checksum_len(next.shared_buffer, len, next.counter);
+        next.access_count = snap.access_count + 1;
+
+        // Commit only if nobody else committed since the snapshot
+        if (seqlock_try_write_begin(&shared_seq, version)) {
+            gpio_set_level(LED_CRITICAL, 1);
+            memcpy(&shared_data, &next, sizeof(next));
+            seqlock_write_end(&shared_seq);
+            gpio_set_level(LED_CRITICAL, 0); gpio_set_level(led_pin, 0);
+            lab_counter_inc(stats.successful_access);
+            record_commit(task_id, start_us);
+            ESP_LOGI(TAG, "[%s] ✓ Committed v%lu", task_name, version + 2);
+            return;
+        }
+        lab_counter_inc(task_stats[task_id - 1].conflicts);
+        ESP_LOGW(TAG, "[%s] Version conflict, retrying", task_name);
+    }
+    gpio_set_level(led_pin, 0);
+    ESP_LOGW(TAG, "[%s] ✗ Gave up after %d conflicts", task_name, OPTIMISTIC_MAX_ATTEMPTS);
+    lab_counter_inc(stats.failed_access);
+}
+#else
+void access_shared_resource(int task_id, const char* task_name, gpio_num_t led_pin) {
+    int64_t start_us = esp_timer_get_time();
     ESP_LOGI(TAG, "[%s] Requesting access...", task_name);
-    if (xSemaphoreTake(xMutex, pdMS_TO_TICKS(5000)) == pdTRUE) {
+    if (lock_prof_take(xMutexProf, pdMS_TO_TICKS(5000)) == pdTRUE) {
         ESP_LOGI(TAG, "[%s] ✓ Mutex acquired", task_name);
-        stats.successful_access++;
+        lab_counter_inc(stats.successful_access);
         gpio_set_level(led_pin, 1); gpio_set_level(LED_CRITICAL, 1);
 
         // CRITICAL SECTION
@@ -44,23 +123,27 @@ void access_shared_resource(int task_id, const char* task_name, gpio_num_t led_p
         uint32_t calculated_checksum = calculate_checksum(temp_buffer, temp_counter);
         if (calculated_checksum != expected_checksum && shared_data.access_count > 0) {
             ESP_LOGE(TAG, "[%s] ⚠️ DATA CORRUPTION DETECTED!", task_name);
-            stats.corruption_detected++;
+            lab_counter_inc(stats.corruption_detected);
         }
         vTaskDelay(pdMS_TO_TICKS(500 + (esp_random() % 1000)));
+        seqlock_write_begin(&shared_seq);
         shared_data.counter = temp_counter + 1;
-        snprintf(shared_data.shared_buffer, sizeof(shared_data.shared_buffer), "Modified by %s #%lu", task_name, shared_data.counter);
-        shared_data.checksum = calculate_checksum(shared_data.shared_buffer, shared_data.counter);
+        size_t len = format_modifier(shared_data.shared_buffer, task_name, shared_data.counter);
+        shared_data.checksum = calculate_checksum_len(shared_data.shared_buffer, len, shared_data.counter);
         shared_data.access_count++;
+        seqlock_write_end(&shared_seq);
         // END CRITICAL SECTION
 
         gpio_set_level(led_pin, 0); gpio_set_level(LED_CRITICAL, 0);
-        xSemaphoreGive(xMutex);
+        lock_prof_give(xMutexProf);
+        record_commit(task_id, start_us);
         ESP_LOGI(TAG, "[%s] Mutex released", task_name);
     } else {
         ESP_LOGW(TAG, "[%s] ✗ Failed to acquire mutex", task_name);
-        stats.failed_access++;
+        lab_counter_inc(stats.failed_access);
     }
 }
+#endif
 
 void high_priority_task(void *p) {
     while (1) {
@@ -83,33 +166,187 @@ void low_priority_task(void *p) {
     }
 }
 
+// Consistent copy of shared_data without taking xMutex (never waits behind a writer's sleep)
+static uint32_t snapshot_shared(shared_resource_t *out) {
+    return seqlock_read_copy(&shared_seq, out, &shared_data, sizeof(*out));
+}
+
 void monitor_task(void *p) {
+    uint32_t snapshot_retries = 0;
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(15000));
-        ESP_LOGI(TAG, "\n═══ MUTEX MONITOR | Success: %lu | Failed: %lu | Corrupted: %lu ═══", stats.successful_access, stats.failed_access, stats.corruption_detected);
-        uint32_t current_checksum = calculate_checksum(shared_data.shared_buffer, shared_data.counter);
-        if (current_checksum != shared_data.checksum && shared_data.access_count > 0) {
+        ESP_LOGI(TAG, "\n═══ MUTEX MONITOR | Success: %lu | Failed: %lu | Corrupted: %lu ═══",
+                 (unsigned long)lab_counter_read(stats.successful_access), (unsigned long)lab_counter_read(stats.failed_access), (unsigned long)lab_counter_read(stats.corruption_detected));
+        shared_resource_t snap;
+        snapshot_retries += snapshot_shared(&snap);
+        uint32_t current_checksum = calculate_checksum(snap.shared_buffer, snap.counter);
+        if (current_checksum != snap.checksum && snap.access_count > 0) {
             ESP_LOGE(TAG, "⚠️ CURRENT DATA CORRUPTION DETECTED!");
         }
-        ESP_LOGI(TAG, "Shared Counter: %lu | Last Modifier: %s\n", shared_data.counter, shared_data.shared_buffer);
+        ESP_LOGI(TAG, "Shared Counter: %lu | Last Modifier: %s | Snapshot retries: %lu", (unsigned long)snap.counter, snap.shared_buffer, (unsigned long)snapshot_retries);
+#if USE_OPTIMISTIC_UPDATES
+        ESP_LOGI(TAG, "Per-task (optimistic updates):");
+#else
+        ESP_LOGI(TAG, "Per-task (pessimistic xMutex):");
+        lock_prof_print(TAG);
+#endif
+        uint32_t minutes_x10 = (uint32_t)((esp_timer_get_time() - lab_start_us) / 6000000);
+        for (int i = 0; i < ACCESS_TASKS; i++) {
+            lab_hist_summary_t lat;
+            lab_hist_summary(task_stats[i].latency_ms, &lat);
+            uint32_t commits = lab_counter_read(task_stats[i].commits);
+            ESP_LOGI(TAG, "  %-8s commits %4lu (%lu.%lu/min) | conflicts %3lu | latency ms p50 %5lu p99 %5lu max %5lu",
+                     task_stats[i].name, (unsigned long)commits, (unsigned long)(minutes_x10 ? commits * 10 / minutes_x10 : 0),
+                     (unsigned long)(minutes_x10 ? (commits * 100 / minutes_x10) % 10 : 0),
+                     (unsigned long)lab_counter_read(task_stats[i].conflicts), (unsigned long)lat.p50, (unsigned long)lat.p99, (unsigned long)lat.max);
+        }
     }
 }
 
+#if RUN_SEQLOCK_BENCHMARK
+static volatile bool bench_writers_run;
+
+// Same shape as access_shared_resource: hold the mutex across a tick of "work", then publish
+static void bench_writer_task(void *p) {
+    const char *name = (const char *)p;
+    while (bench_writers_run) {
+        xSemaphoreTake(xMutex, portMAX_DELAY);
+        vTaskDelay(1);
+        seqlock_write_begin(&shared_seq);
+        shared_data.counter++;
+        size_t len = format_modifier(shared_data.shared_buffer, name, shared_data.counter);
+        shared_data.checksum = calculate_checksum_len(shared_data.shared_buffer, len, shared_data.counter);
+        shared_data.access_count++;
+        seqlock_write_end(&shared_seq);
+        xSemaphoreGive(xMutex);
+        taskYIELD();
+    }
+    vTaskDelete(NULL);
+}
+
+// Times one seqlock snapshot and one mutex-protected copy per tick while two writers
+// keep the mutex busy. Runs on app_main's core so the cycle counter is consistent.
+static void seqlock_benchmark(void) {
+    lab_histogram_t *h_seq = lab_histogram("read_seqlock_cyc"), *h_mtx = lab_histogram("read_mutex_cyc");
+    if (!h_seq || !h_mtx) return;
+    uint32_t retries = 0, torn = 0;
+    bench_writers_run = true;
+    xTaskCreate(bench_writer_task, "BenchW1", 3072, "BENCH_W1", 3, NULL);
+    xTaskCreate(bench_writer_task, "BenchW2", 3072, "BENCH_W2", 3, NULL);
+
+    UBaseType_t prio = uxTaskPriorityGet(NULL);
+    vTaskPrioritySet(NULL, 4);
+    for (int i = 0; i < SEQLOCK_BENCH_READS; i++) {
+        shared_resource_t snap;
+        esp_cpu_cycle_count_t t0 = esp_cpu_get_cycle_count();
+        retries += snapshot_shared(&snap);
+        esp_cpu_cycle_count_t t1 = esp_cpu_get_cycle_count();
+        lab_hist_record(h_seq, t1 - t0);
+        if (calculate_checksum(snap.shared_buffer, snap.counter) != snap.checksum) torn++;
+
+        t0 = esp_cpu_get_cycle_count();
+        xSemaphoreTake(xMutex, portMAX_DELAY);
+        memcpy(&snap, &shared_data, sizeof(snap));
+        xSemaphoreGive(xMutex);
+        t1 = esp_cpu_get_cycle_count();
+        lab_hist_record(h_mtx, t1 - t0);
+        vTaskDelay(1);
+    }
+    vTaskPrioritySet(NULL, prio);
+    bench_writers_run = false;
+    vTaskDelay(pdMS_TO_TICKS(100));    // Let the writers exit
+
+    lab_hist_summary_t seq, mtx;
+    lab_hist_summary(h_seq, &seq);
+    lab_hist_summary(h_mtx, &mtx);
+    ESP_LOGI(TAG, "📈 Reader latency under 2 writers (%d reads, CPU cycles):", SEQLOCK_BENCH_READS);
+    ESP_LOGI(TAG, "  seqlock  p50 %lu | p99 %lu | max %lu | retries %lu | torn %lu", (unsigned long)seq.p50, (unsigned long)seq.p99, (unsigned long)seq.max, (unsigned long)retries, (unsigned long)torn);
+    ESP_LOGI(TAG, "  mutex    p50 %lu | p99 %lu | max %lu", (unsigned long)mtx.p50, (unsigned long)mtx.p99, (unsigned long)mtx.max);
+
+    // Start the lab from a clean resource
+    memset(&shared_data, 0, sizeof(shared_data));
+}
+#endif
+
+#if RUN_CHECKSUM_BENCHMARK
+#define CHECKSUM_BENCH_REPS 200
+
+// Best-of-N cycles for each algorithm and size, so preemption doesn't skew the result
+static void checksum_benchmark(void) {
+    static const size_t sizes[] = { 16, 64, 256, 1024 };
+    static uint8_t data[1024];
+    for (size_t i = 0; i < sizeof(data); i += 4) {
+        uint32_t r = esp_random();
+        memcpy(&data[i], &r, 4);
+    }
+    ESP_LOGI(TAG, "📈 Checksum cycles/byte (best of %d, active: %s):", CHECKSUM_BENCH_REPS, checksum_algo_name(CHECKSUM_ALGO));
+    for (int algo = 0; algo < CHECKSUM_ALGO_COUNT; algo++) {
+        char line[96];
+        int pos = snprintf(line, sizeof(line), "  %-6s", checksum_algo_name(algo));
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            uint32_t best = UINT32_MAX;
+            volatile uint32_t sink;
+            for (int r = 0; r < CHECKSUM_BENCH_REPS; r++) {
+                esp_cpu_cycle_count_t t0 = esp_cpu_get_cycle_count();
+                sink = checksum_compute_algo(algo, data, sizes[s]);
+                esp_cpu_cycle_count_t cycles = esp_cpu_get_cycle_count() - t0;
+                if (cycles < best) best = cycles;
+            }
+            (void)sink;
+            uint32_t x100 = best * 100 / sizes[s];
+            pos += snprintf(line + pos, sizeof(line) - pos, " | %4uB %3lu.%02lu", (unsigned)sizes[s], (unsigned long)(x100 / 100), (unsigned long)(x100 % 100));
+        }
+        ESP_LOGI(TAG, "%s", line);
+    }
+}
+#endif
+
+static const lab_object_def_t lab_objects[] = {
+    LAB_MUTEX(&xMutex),
+};
+
+static const lab_task_def_t lab_tasks[] = {
+    LAB_TASK(high_priority_task, "HighPri", 3072, NULL, 5, NULL),
+    LAB_TASK(medium_priority_task, "MedPri", 3072, NULL, 3, NULL),
+    LAB_TASK(low_priority_task, "LowPri", 3072, NULL, 2, NULL),
+    LAB_TASK(monitor_task, "Monitor", 3072, NULL, 1, NULL),
+};
+
 void app_main(void) {
     ESP_LOGI(TAG, "Mutex and Critical Sections Lab Starting...");
     gpio_config_t io_conf = { .mode = GPIO_MODE_OUTPUT, .intr_type = GPIO_INTR_DISABLE };
     io_conf.pin_bit_mask = (1ULL<<LED_TASK1)|(1ULL<<LED_TASK2)|(1ULL<<LED_TASK3)|(1ULL<<LED_CRITICAL);
     gpio_config(&io_conf);
 
-    xMutex = xSemaphoreCreateMutex();
-    if (xMutex != NULL) {
+    lab_objects_create(lab_objects, LAB_ARRAY_SIZE(lab_objects));
+    stats.successful_access = lab_counter("successful_access");
+    stats.failed_access = lab_counter("failed_access");
+    stats.corruption_detected = lab_counter("corruption_detected");
+    xMutexProf = xMutex ? lock_prof_create("xMutex", xMutex) : NULL;
+    bool task_stats_ok = true;
+    for (int i = 0; i < ACCESS_TASKS; i++) {
+        char name[LAB_METRICS_NAME_LEN];
+        snprintf(name, sizeof(name), "%s.commits", task_stats[i].name);
+        task_stats[i].commits = lab_counter(name);
+        snprintf(name, sizeof(name), "%s.conflicts", task_stats[i].name);
+        task_stats[i].conflicts = lab_counter(name);
+        snprintf(name, sizeof(name), "%s.lat_ms", task_stats[i].name);
+        task_stats[i].latency_ms = lab_histogram(name);
+        task_stats_ok = task_stats_ok && task_stats[i].commits && task_stats[i].conflicts && task_stats[i].latency_ms;
+    }
+    if (xMutex != NULL && xMutexProf && task_stats_ok && stats.successful_access && stats.failed_access && stats.corruption_detected) {
         ESP_LOGI(TAG, "Mutex created successfully");
+#if RUN_CHECKSUM_BENCHMARK
+        checksum_benchmark();
+#endif
+#if RUN_SEQLOCK_BENCHMARK
+        seqlock_benchmark();
+#endif
         shared_data.checksum = calculate_checksum(shared_data.shared_buffer, shared_data.counter);
 
-        xTaskCreate(high_priority_task, "HighPri", 3072, NULL, 5, NULL);
-        xTaskCreate(medium_priority_task, "MedPri", 3072, NULL, 3, NULL);
-        xTaskCreate(low_priority_task, "LowPri", 3072, NULL, 2, NULL);
-        xTaskCreate(monitor_task, "Monitor", 3072, NULL, 1, NULL);
+        lab_start_us = esp_timer_get_time(); // commits/min are measured from here
+        lab_tasks_create(lab_tasks, LAB_ARRAY_SIZE(lab_tasks));
+        lab_alloc_report(TAG);
     } else {
         ESP_LOGE(TAG, "Failed to create mutex!");
     }
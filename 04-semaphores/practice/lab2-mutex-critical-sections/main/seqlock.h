@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/*
+ * Sequence lock: lets readers take a consistent copy of a structure without
+ * ever blocking the writer.
+ *
+ * The sequence is odd while a write is in progress and is bumped by two per
+ * completed write. A reader copies the data between two loads of the sequence
+ * and retries if a write was in progress or completed meanwhile.
+ *
+ * Writers must already be serialized (the lab holds xMutex around them);
+ * seqlock_write_begin()/end() only publish the update to lock-free readers.
+ * Alternatively, lock-free writers claim the write with
+ * seqlock_try_write_begin() on the version they read: it only succeeds if no
+ * other write happened since, which gives optimistic (compare-and-swap)
+ * commits. Don't mix the two kinds of writer on the same seqlock.
+ * A writer preempted mid-update on the reader's core would starve a spinning
+ * reader, so the reader sleeps a tick after SEQLOCK_SPIN_LIMIT odd reads.
+ */
+
+#define SEQLOCK_SPIN_LIMIT 64
+
+typedef struct { _Atomic uint32_t seq; } seqlock_t;
+
+#define SEQLOCK_INIT { 0 }
+
+static inline void seqlock_write_begin(seqlock_t *sl) {
+    uint32_t s = atomic_load_explicit(&sl->seq, memory_order_relaxed);
+    atomic_store_explicit(&sl->seq, s + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);    // odd sequence visible before any data store
+}
+
+// Claims the write only if the sequence is still at version (an even value from a read)
+static inline bool seqlock_try_write_begin(seqlock_t *sl, uint32_t version) {
+    if (!atomic_compare_exchange_strong_explicit(&sl->seq, &version, version + 1,
+                                                 memory_order_acquire, memory_order_relaxed)) {
+        return false;
+    }
+    atomic_thread_fence(memory_order_release);
+    return true;
+}
+
+static inline void seqlock_write_end(seqlock_t *sl) {
+    uint32_t s = atomic_load_explicit(&sl->seq, memory_order_relaxed);
+    atomic_store_explicit(&sl->seq, s + 1, memory_order_release);
+}
+
+// Returns the even sequence to pass to seqlock_read_retry(); spins past writers in progress
+static inline uint32_t seqlock_read_begin(const seqlock_t *sl) {
+    uint32_t s, spins = 0;
+    while ((s = atomic_load_explicit(&sl->seq, memory_order_acquire)) & 1) {
+        if (++spins >= SEQLOCK_SPIN_LIMIT) { vTaskDelay(1); spins = 0; }
+    }
+    return s;
+}
+
+static inline bool seqlock_read_retry(const seqlock_t *sl, uint32_t start) {
+    atomic_thread_fence(memory_order_acquire);    // data loads complete before the re-check
+    return atomic_load_explicit(&sl->seq, memory_order_relaxed) != start;
+}
+
+// Copies size bytes from src into dst as one consistent snapshot and returns the
+// version it corresponds to; *retries (optional) is increased by the number of re-reads
+static inline uint32_t seqlock_read_versioned(const seqlock_t *sl, void *dst, const volatile void *src, size_t size,
+                                              uint32_t *retries) {
+    while (1) {
+        uint32_t start = seqlock_read_begin(sl);
+        memcpy(dst, (const void *)src, size);
+        if (!seqlock_read_retry(sl, start)) return start;
+        if (retries) (*retries)++;
+    }
+}
+
+// Same, returning only the number of retries
+static inline uint32_t seqlock_read_copy(const seqlock_t *sl, void *dst, const volatile void *src, size_t size) {
+    uint32_t retries = 0;
+    seqlock_read_versioned(sl, dst, src, size, &retries);
+    return retries;
+}
@@ -0,0 +1,765 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/timers.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "esp_random.h"
+#include "driver/gpio.h"
+#include "deferred_work.h"
+#include "lab_metrics.h"
+#include "rt_stats.h"
+#include "timer_jitter.h"
+#include "timer_wheel.h"
+
+static const char *TAG = "ADV_TIMERS";
+
+// ================ CONFIGURATION ================
+#define TIMER_POOL_SIZE              20
+#define DYNAMIC_TIMER_MAX            10
+#define HEALTH_CHECK_INTERVAL        1000
+
+// Heavy callbacks (health monitor) hand their work to a worker pool instead of
+// running it in the timer service task; 0 runs it inline for comparison
+#define USE_DEFERRED_WORK            1
+#define DEFERRED_WORKERS             2
+
+// Logical timers on the timing wheel that run alongside the pooled stress timers (0 = none)
+#define STRESS_WHEEL_TIMERS          1000
+
+// Start/stop throughput and expiry rate of the timing wheel vs native timers, before the lab starts
+#define RUN_WHEEL_BENCHMARK          1
+#define WHEEL_BENCH_MAX_TIMERS       2000
+#define WHEEL_BENCH_RUN_MS           3000
+
+// Expiry lateness CSV over timer count x period x service priority x CPU load (~2 min, see timer_jitter.c)
+#define RUN_JITTER_SWEEP             1
+
+// LEDs for visual feedback
+#define PERFORMANCE_LED     GPIO_NUM_2
+#define HEALTH_LED         GPIO_NUM_4
+#define STRESS_LED         GPIO_NUM_5
+#define ERROR_LED          GPIO_NUM_18
+
+// ================ DATA STRUCTURES ================
+
+// Timer Pool Entry
+typedef struct {
+    TimerHandle_t handle;
+    bool in_use;
+    uint32_t id;
+    char name[16];
+    TickType_t period;
+    bool auto_reload;
+    TimerCallbackFunction_t callback;
+    void* context;
+    uint32_t creation_time;
+    uint32_t start_count;
+    uint32_t callback_count;
+} timer_pool_entry_t;
+
+// System Health Data
+typedef struct {
+    uint32_t total_timers_created;
+    uint32_t active_timers;
+    uint32_t pool_utilization;
+    uint32_t dynamic_timers;
+    uint32_t failed_creations;
+    uint32_t callback_overruns;
+    uint32_t command_failures;
+    float average_accuracy;
+    uint32_t service_task_load_percent;
+    uint32_t free_heap_bytes;
+} timer_health_t;
+
+// ================ GLOBAL VARIABLES ================
+
+// Timer Pool Management
+timer_pool_entry_t timer_pool[TIMER_POOL_SIZE];
+SemaphoreHandle_t pool_mutex;
+uint32_t next_timer_id = 1000;
+
+// Performance Monitoring (every callback, reset each analysis window)
+lab_histogram_t *perf_lateness_hist;
+lab_histogram_t *perf_callback_hist;
+lab_counter_t *perf_samples;
+lab_counter_t *perf_accurate;
+
+// Health Monitoring
+timer_health_t health_data = {0};
+TimerHandle_t health_monitor_timer;
+TimerHandle_t performance_timer;
+
+// Deferred work and timer service occupancy
+deferred_work_t timer_work;
+timer_probe_t health_probe;
+timer_probe_t perf_probe;
+
+// Dynamic Timer Tracking
+TimerHandle_t dynamic_timers[DYNAMIC_TIMER_MAX];
+uint32_t dynamic_timer_count = 0;
+
+// Test Infrastructure
+QueueHandle_t test_result_queue;
+TaskHandle_t stress_test_task_handle;
+
+// ================ TIMER POOL MANAGEMENT ================
+
+void init_timer_pool(void) {
+    pool_mutex = xSemaphoreCreateMutex();
+    
+    for (int i = 0; i < TIMER_POOL_SIZE; i++) {
+        timer_pool[i].handle = NULL;
+        timer_pool[i].in_use = false;
+        timer_pool[i].id = 0;
+        memset(timer_pool[i].name, 0, sizeof(timer_pool[i].name));
+        timer_pool[i].creation_time = 0;
+        timer_pool[i].start_count = 0;
+        timer_pool[i].callback_count = 0;
+    }
+    
+    ESP_LOGI(TAG, "Timer pool initialized with %d slots", TIMER_POOL_SIZE);
+}
+
+timer_pool_entry_t* allocate_from_pool(const char* name, TickType_t period, 
+                                      bool auto_reload, TimerCallbackFunction_t callback,
+                                      void* context) {
+    if (xSemaphoreTake(pool_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to acquire pool mutex");
+        return NULL;
+    }
+    
+    timer_pool_entry_t* entry = NULL;
+    
+    // Find free slot
+    for (int i = 0; i < TIMER_POOL_SIZE; i++) {
+        if (!timer_pool[i].in_use) {
+            entry = &timer_pool[i];
+            entry->in_use = true;
+            entry->id = next_timer_id++;
+            strncpy(entry->name, name, sizeof(entry->name) - 1);
+            entry->period = period;
+            entry->auto_reload = auto_reload;
+            entry->callback = callback;
+            entry->context = context;
+            entry->creation_time = xTaskGetTickCount();
+            entry->start_count = 0;
+            entry->callback_count = 0;
+            
+            // Create actual timer
+            entry->handle = xTimerCreate(name, period, auto_reload, 
+                                       (void*)entry->id, callback);
+            
+            if (entry->handle == NULL) {
+                entry->in_use = false;
+                entry = NULL;
+                health_data.failed_creations++;
+            } else {
+                health_data.total_timers_created++;
+            }
+            break;
+        }
+    }
+    
+    if (entry == NULL) {
+        ESP_LOGW(TAG, "Timer pool exhausted");
+        health_data.failed_creations++;
+    }
+    
+    xSemaphoreGive(pool_mutex);
+    return entry;
+}
+
+void release_to_pool(uint32_t timer_id) {
+    if (xSemaphoreTake(pool_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return;
+    }
+    
+    for (int i = 0; i < TIMER_POOL_SIZE; i++) {
+        if (timer_pool[i].in_use && timer_pool[i].id == timer_id) {
+            if (timer_pool[i].handle) {
+                xTimerDelete(timer_pool[i].handle, 0);
+            }
+            timer_pool[i].in_use = false;
+            timer_pool[i].handle = NULL;
+            ESP_LOGI(TAG, "Released timer %lu from pool", (unsigned long)timer_id);
+            break;
+        }
+    }
+    
+    xSemaphoreGive(pool_mutex);
+}
+
+// ================ PERFORMANCE MONITORING ================
+
+void record_performance_sample(uint32_t timer_id, uint32_t duration_us,
+                               uint32_t lateness_us, uint32_t period_us) {
+    lab_hist_record(perf_callback_hist, duration_us);
+    lab_hist_record(perf_lateness_hist, lateness_us);
+    lab_counter_inc(perf_samples);
+
+    // Accurate: fired within 5% of its period after the due tick
+    if ((uint64_t)lateness_us * 100 <= (uint64_t)period_us * 5) {
+        lab_counter_inc(perf_accurate);
+    }
+
+    if (duration_us > 1000) { // > 1ms is concerning
+        health_data.callback_overruns++;
+    }
+}
+
+void analyze_performance(void) {
+    static uint32_t last_samples = 0;
+    static uint32_t last_accurate = 0;
+
+    uint32_t samples = lab_counter_read(perf_samples);
+    uint32_t accurate = lab_counter_read(perf_accurate);
+    uint32_t sample_count = samples - last_samples;
+    uint32_t accurate_timers = accurate - last_accurate;
+    last_samples = samples;
+    last_accurate = accurate;
+
+    if (sample_count > 0) {
+        lab_hist_summary_t duration;
+        lab_hist_summary_t lateness;
+        lab_hist_summary(perf_callback_hist, &duration);
+        lab_hist_summary(perf_lateness_hist, &lateness);
+        lab_hist_reset(perf_callback_hist);
+        lab_hist_reset(perf_lateness_hist);
+        health_data.average_accuracy = (float)accurate_timers / sample_count * 100.0;
+        
+        ESP_LOGI(TAG, "📊 Performance Analysis:");
+        ESP_LOGI(TAG, "  Callback Duration: Avg=%luμs, p99=%luμs, Max=%luμs", 
+                 (unsigned long)duration.mean, (unsigned long)duration.p99, (unsigned long)duration.max);
+        ESP_LOGI(TAG, "  Expiry Lateness: p50=%luμs, p90=%luμs, p99=%luμs, Max=%luμs",
+                 (unsigned long)lateness.p50, (unsigned long)lateness.p90, (unsigned long)lateness.p99, (unsigned long)lateness.max);
+        ESP_LOGI(TAG, "  Timer Accuracy: %.1f%% (%lu/%lu)", 
+                 health_data.average_accuracy, (unsigned long)accurate_timers, (unsigned long)sample_count);
+        ESP_LOGI(TAG, "  Callback Overruns: %lu", (unsigned long)health_data.callback_overruns);
+        
+        // Visual feedback
+        if (duration.mean > 500) {
+            gpio_set_level(PERFORMANCE_LED, 1); // Warning
+        } else {
+            gpio_set_level(PERFORMANCE_LED, 0);
+        }
+    }
+}
+
+// ================ TIMER CALLBACKS ================
+
+void performance_test_callback(TimerHandle_t timer) {
+    int64_t probe_start = timer_probe_begin();
+    uint32_t start_time = esp_timer_get_time();
+    uint32_t timer_id = (uint32_t)pvTimerGetTimerID(timer);
+    TickType_t period = xTimerGetPeriod(timer);
+
+    // Auto-reload timers are re-armed before the callback runs, so the due tick is one period back
+    TickType_t due = xTimerGetExpiryTime(timer);
+    if (uxTimerGetReloadMode(timer) != 0) {
+        due -= period;
+    }
+    uint32_t lateness_us = tick_clock_lateness_us(due);
+    
+    // Simulate variable processing time
+    volatile uint32_t iterations = 100 + (esp_random() % 500);
+    for (volatile uint32_t i = 0; i < iterations; i++) {
+        // Simulate work
+    }
+    
+    uint32_t end_time = esp_timer_get_time();
+    uint32_t duration_us = end_time - start_time;
+    
+    record_performance_sample(timer_id, duration_us, lateness_us, pdTICKS_TO_MS(period) * 1000);
+    
+    // Update timer stats
+    for (int i = 0; i < TIMER_POOL_SIZE; i++) {
+        if (timer_pool[i].in_use && timer_pool[i].id == timer_id) {
+            timer_pool[i].callback_count++;
+            break;
+        }
+    }
+
+    timer_probe_end(&perf_probe, probe_start);
+}
+
+void stress_test_callback(TimerHandle_t timer) {
+    static uint32_t stress_counter = 0;
+    stress_counter++;
+    
+    // Quick processing only
+    if (stress_counter % 100 == 0) {
+        ESP_LOGI(TAG, "💪 Stress test callback #%lu", (unsigned long)stress_counter);
+        gpio_set_level(STRESS_LED, stress_counter % 2);
+    }
+}
+
+#if STRESS_WHEEL_TIMERS > 0
+static wheel_timer_t stress_wheel_timers[STRESS_WHEEL_TIMERS];
+static volatile uint32_t stress_wheel_expiries = 0;
+
+void stress_wheel_callback(wheel_timer_t *timer) {
+    stress_wheel_expiries++;
+}
+#endif
+
+// Pool scan (may wait for pool_mutex) and report: too slow for the timer service task
+void health_monitor_work(void *arg, uint32_t unused) {
+    // Update health metrics
+    health_data.free_heap_bytes = esp_get_free_heap_size();
+    
+    uint32_t active_count = 0;
+    uint32_t pool_used = 0;
+    
+    if (xSemaphoreTake(pool_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+        for (int i = 0; i < TIMER_POOL_SIZE; i++) {
+            if (timer_pool[i].in_use) {
+                pool_used++;
+                if (xTimerIsTimerActive(timer_pool[i].handle)) {
+                    active_count++;
+                }
+            }
+        }
+        xSemaphoreGive(pool_mutex);
+    }
+    
+    health_data.active_timers = active_count;
+    health_data.pool_utilization = (pool_used * 100) / TIMER_POOL_SIZE;
+    health_data.dynamic_timers = dynamic_timer_count;
+    
+    // Health status LED
+    if (health_data.pool_utilization > 80 || health_data.callback_overruns > 10) {
+        gpio_set_level(HEALTH_LED, 1); // Warning
+    } else {
+        gpio_set_level(HEALTH_LED, 0);
+    }
+    
+    ESP_LOGI(TAG, "🏥 Health Monitor:");
+    ESP_LOGI(TAG, "  Active Timers: %lu/%lu", (unsigned long)active_count, (unsigned long)pool_used);
+    ESP_LOGI(TAG, "  Pool Utilization: %lu%%", (unsigned long)health_data.pool_utilization);
+    ESP_LOGI(TAG, "  Dynamic Timers: %lu/%d", (unsigned long)health_data.dynamic_timers, DYNAMIC_TIMER_MAX);
+    ESP_LOGI(TAG, "  Free Heap: %lu bytes", (unsigned long)health_data.free_heap_bytes);
+    ESP_LOGI(TAG, "  Failed Creations: %lu", (unsigned long)health_data.failed_creations);
+
+    timer_wheel_stats_t wheel_stats;
+    timer_wheel_get_stats(&wheel_stats);
+    ESP_LOGI(TAG, "  Wheel Timers: %lu active, %lu expired, %lu cascaded, %lu late ticks, max tick %luμs",
+             (unsigned long)wheel_stats.active, (unsigned long)wheel_stats.expired, (unsigned long)wheel_stats.cascaded,
+             (unsigned long)wheel_stats.late_ticks, (unsigned long)wheel_stats.max_advance_us);
+}
+
+void health_monitor_callback(TimerHandle_t timer) {
+    int64_t start = timer_probe_begin();
+#if USE_DEFERRED_WORK
+    deferred_work_submit(&timer_work, health_monitor_work, NULL, 0);
+#else
+    health_monitor_work(NULL, 0);
+#endif
+    timer_probe_end(&health_probe, start);
+}
+
+// ================ DYNAMIC TIMER MANAGEMENT ================
+
+TimerHandle_t create_dynamic_timer(const char* name, uint32_t period_ms, 
+                                  bool auto_reload, TimerCallbackFunction_t callback) {
+    if (dynamic_timer_count >= DYNAMIC_TIMER_MAX) {
+        ESP_LOGW(TAG, "Dynamic timer limit reached");
+        return NULL;
+    }
+    
+    TimerHandle_t timer = xTimerCreate(name, pdMS_TO_TICKS(period_ms), 
+                                     auto_reload, (void*)next_timer_id++, callback);
+    
+    if (timer != NULL) {
+        dynamic_timers[dynamic_timer_count] = timer;
+        dynamic_timer_count++;
+        ESP_LOGI(TAG, "Created dynamic timer: %s", name);
+    }
+    
+    return timer;
+}
+
+void cleanup_dynamic_timers(void) {
+    for (uint32_t i = 0; i < dynamic_timer_count; i++) {
+        if (dynamic_timers[i] != NULL) {
+            xTimerDelete(dynamic_timers[i], pdMS_TO_TICKS(100));
+            dynamic_timers[i] = NULL;
+        }
+    }
+    dynamic_timer_count = 0;
+    ESP_LOGI(TAG, "Cleaned up all dynamic timers");
+}
+
+// ================ STRESS TESTING ================
+
+void stress_test_task(void *parameter) {
+    ESP_LOGI(TAG, "🔥 Starting stress test...");
+    
+    // Create many timers with different periods
+    timer_pool_entry_t* stress_timers[10];
+    
+    for (int i = 0; i < 10; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "Stress%d", i);
+        
+        uint32_t period = 100 + (i * 50); // 100ms to 550ms
+        stress_timers[i] = allocate_from_pool(name, pdMS_TO_TICKS(period), 
+                                            true, stress_test_callback, NULL);
+        
+        if (stress_timers[i] != NULL) {
+            xTimerStart(stress_timers[i]->handle, 0);
+        }
+        
+        vTaskDelay(pdMS_TO_TICKS(100)); // Stagger creation
+    }
+    
+#if STRESS_WHEEL_TIMERS > 0
+    // Thousands of logical timers cost one FreeRTOS timer and no command queue traffic
+    for (int i = 0; i < STRESS_WHEEL_TIMERS; i++) {
+        TickType_t period = pdMS_TO_TICKS(100 + (i % 10) * 50); // 100ms to 550ms
+        wheel_timer_init(&stress_wheel_timers[i], stress_wheel_callback, NULL);
+        wheel_timer_start(&stress_wheel_timers[i], 1 + i % period, period);
+    }
+    ESP_LOGI(TAG, "Started %d wheel timers", STRESS_WHEEL_TIMERS);
+#endif
+
+    // Run stress test for 30 seconds
+    vTaskDelay(pdMS_TO_TICKS(30000));
+
+#if STRESS_WHEEL_TIMERS > 0
+    for (int i = 0; i < STRESS_WHEEL_TIMERS; i++) {
+        wheel_timer_stop(&stress_wheel_timers[i]);
+    }
+    ESP_LOGI(TAG, "Wheel stress: %lu callbacks from %d timers in 30 s",
+             (unsigned long)stress_wheel_expiries, STRESS_WHEEL_TIMERS);
+#endif
+    
+    // Clean up stress timers
+    for (int i = 0; i < 10; i++) {
+        if (stress_timers[i] != NULL) {
+            xTimerStop(stress_timers[i]->handle, pdMS_TO_TICKS(100));
+            release_to_pool(stress_timers[i]->id);
+        }
+    }
+    
+    ESP_LOGI(TAG, "Stress test completed");
+    
+    // Create some dynamic timers for testing
+    for (int i = 0; i < 5; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "Dynamic%d", i);
+        
+        TimerHandle_t dt = create_dynamic_timer(name, 200 + (i * 100), 
+                                              true, performance_test_callback);
+        if (dt != NULL) {
+            xTimerStart(dt, 0);
+        }
+    }
+    
+    vTaskDelete(NULL);
+}
+
+// ================ TIMING WHEEL BENCHMARK ================
+
+#if RUN_WHEEL_BENCHMARK
+static const uint32_t wheel_bench_counts[] = {100, 500, WHEEL_BENCH_MAX_TIMERS};
+
+static TimerHandle_t bench_native_timers[WHEEL_BENCH_MAX_TIMERS];
+static wheel_timer_t bench_wheel_timers[WHEEL_BENCH_MAX_TIMERS];
+static volatile uint32_t bench_expiries;
+static rt_stats_t bench_rt_stats;
+
+typedef struct {
+    uint32_t timers;            // timers actually created
+    uint32_t ops_per_sec;       // start + stop calls per second
+    uint32_t expiries_per_sec;
+    uint32_t expected_per_sec;
+    uint32_t service_permille;  // timer service task CPU share during the expiry phase
+    uint32_t bytes_per_timer;
+} bench_result_t;
+
+static void bench_native_callback(TimerHandle_t timer) {
+    bench_expiries++;
+}
+
+static void bench_wheel_callback(wheel_timer_t *timer) {
+    bench_expiries++;
+}
+
+// 20..90 ms, spread so expiries do not all land on the same tick
+static TickType_t bench_period(uint32_t i) {
+    TickType_t period = pdMS_TO_TICKS(20 + (i % 8) * 10);
+    return period > 0 ? period : 1;
+}
+
+static uint32_t bench_expected_per_sec(uint32_t count) {
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        total += configTICK_RATE_HZ / bench_period(i);
+    }
+    return total;
+}
+
+// Runs in the timer service task once every command queued before it is done
+static void bench_queue_marker(void *task, uint32_t unused) {
+    xTaskNotifyGive((TaskHandle_t)task);
+}
+
+static void bench_drain_command_queue(void) {
+    xTimerPendFunctionCall(bench_queue_marker, xTaskGetCurrentTaskHandle(), 0, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+static uint32_t timer_service_permille(const rt_stats_t *stats) {
+    TaskHandle_t service = xTimerGetTimerDaemonTaskHandle();
+    for (UBaseType_t i = 0; i < stats->count; i++) {
+        if (stats->status[i].xHandle == service) {
+            return rt_stats_cpu_permille(stats, i);
+        }
+    }
+    return 0;
+}
+
+static void bench_native(uint32_t count, bench_result_t *result) {
+    uint32_t heap_before = esp_get_free_heap_size();
+    uint32_t n = 0;
+    while (n < count) {
+        bench_native_timers[n] = xTimerCreate("Bench", bench_period(n), pdTRUE, NULL, bench_native_callback);
+        if (bench_native_timers[n] == NULL) {
+            break;
+        }
+        n++;
+    }
+    result->timers = n;
+    result->bytes_per_timer = n ? (heap_before - esp_get_free_heap_size()) / n : 0;
+
+    // Every call is a command the timer service task has to dequeue and sort in
+    int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; i < n; i++) {
+        xTimerStart(bench_native_timers[i], portMAX_DELAY);
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        xTimerStop(bench_native_timers[i], portMAX_DELAY);
+    }
+    bench_drain_command_queue();
+    int64_t elapsed = esp_timer_get_time() - start;
+    result->ops_per_sec = elapsed > 0 ? (uint32_t)(2LL * n * 1000000 / elapsed) : 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        xTimerStart(bench_native_timers[i], portMAX_DELAY);
+    }
+    bench_drain_command_queue();
+    rt_stats_sample(&bench_rt_stats);
+    bench_expiries = 0;
+    vTaskDelay(pdMS_TO_TICKS(WHEEL_BENCH_RUN_MS));
+    uint32_t expiries = bench_expiries;
+    rt_stats_sample(&bench_rt_stats);
+    result->expiries_per_sec = expiries * 1000 / WHEEL_BENCH_RUN_MS;
+    result->expected_per_sec = bench_expected_per_sec(n);
+    result->service_permille = timer_service_permille(&bench_rt_stats);
+
+    for (uint32_t i = 0; i < n; i++) {
+        xTimerDelete(bench_native_timers[i], portMAX_DELAY);
+        bench_native_timers[i] = NULL;
+    }
+    bench_drain_command_queue();
+}
+
+static void bench_wheel(uint32_t count, bench_result_t *result) {
+    result->timers = count;
+    result->bytes_per_timer = sizeof(wheel_timer_t);
+    for (uint32_t i = 0; i < count; i++) {
+        wheel_timer_init(&bench_wheel_timers[i], bench_wheel_callback, NULL);
+    }
+
+    int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; i < count; i++) {
+        wheel_timer_start(&bench_wheel_timers[i], bench_period(i), bench_period(i));
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        wheel_timer_stop(&bench_wheel_timers[i]);
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    result->ops_per_sec = elapsed > 0 ? (uint32_t)(2LL * count * 1000000 / elapsed) : 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        wheel_timer_start(&bench_wheel_timers[i], bench_period(i), bench_period(i));
+    }
+    rt_stats_sample(&bench_rt_stats);
+    bench_expiries = 0;
+    vTaskDelay(pdMS_TO_TICKS(WHEEL_BENCH_RUN_MS));
+    uint32_t expiries = bench_expiries;
+    rt_stats_sample(&bench_rt_stats);
+    result->expiries_per_sec = expiries * 1000 / WHEEL_BENCH_RUN_MS;
+    result->expected_per_sec = bench_expected_per_sec(count);
+    result->service_permille = timer_service_permille(&bench_rt_stats);
+
+    for (uint32_t i = 0; i < count; i++) {
+        wheel_timer_stop(&bench_wheel_timers[i]);
+    }
+}
+
+static void bench_print(const char *name, uint32_t count, const bench_result_t *r) {
+    ESP_LOGI(TAG, "  %-6s %5lu/%-5lu timers | %7lu start+stop/s | %6lu expiries/s (expected %lu) | Tmr Svc %lu.%lu%% CPU | %lu B/timer",
+             name, (unsigned long)r->timers, (unsigned long)count, (unsigned long)r->ops_per_sec,
+             (unsigned long)r->expiries_per_sec, (unsigned long)r->expected_per_sec,
+             (unsigned long)(r->service_permille / 10), (unsigned long)(r->service_permille % 10),
+             (unsigned long)r->bytes_per_timer);
+}
+
+void wheel_benchmark(void) {
+    rt_stats_init(&bench_rt_stats);
+    ESP_LOGI(TAG, "⏱️ Timing wheel vs native timers (%d ms per run, tick %d ms):",
+             WHEEL_BENCH_RUN_MS, portTICK_PERIOD_MS);
+
+    for (size_t i = 0; i < sizeof(wheel_bench_counts) / sizeof(wheel_bench_counts[0]); i++) {
+        uint32_t count = wheel_bench_counts[i];
+        bench_result_t native = {0};
+        bench_result_t wheel = {0};
+
+        bench_native(count, &native);
+        bench_wheel(count, &wheel);
+        bench_print("native", count, &native);
+        bench_print("wheel", count, &wheel);
+    }
+}
+#endif
+
+// ================ PERFORMANCE ANALYSIS TASK ================
+
+void performance_analysis_task(void *parameter) {
+    ESP_LOGI(TAG, "Performance analysis task started");
+    
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(10000)); // Every 10 seconds
+        
+        analyze_performance();
+        timer_probe_report(TAG);
+#if USE_DEFERRED_WORK
+        deferred_work_report(&timer_work, TAG);
+#endif
+        
+        // Generate performance report
+        ESP_LOGI(TAG, "\n═══ PERFORMANCE REPORT ═══");
+        ESP_LOGI(TAG, "Total Timers Created: %lu", (unsigned long)health_data.total_timers_created);
+        ESP_LOGI(TAG, "Current Active: %lu", (unsigned long)health_data.active_timers);
+        ESP_LOGI(TAG, "Pool Utilization: %lu%%", (unsigned long)health_data.pool_utilization);
+        ESP_LOGI(TAG, "Average Accuracy: %.1f%%", health_data.average_accuracy);
+        ESP_LOGI(TAG, "Callback Overruns: %lu", (unsigned long)health_data.callback_overruns);
+        ESP_LOGI(TAG, "Command Failures: %lu", (unsigned long)health_data.command_failures);
+        ESP_LOGI(TAG, "═════════════════════════\n");
+        
+        // Memory usage check
+        if (health_data.free_heap_bytes < 20000) {
+            ESP_LOGW(TAG, "⚠️ Low memory warning: %lu bytes", (unsigned long)health_data.free_heap_bytes);
+            gpio_set_level(ERROR_LED, 1);
+        } else {
+            gpio_set_level(ERROR_LED, 0);
+        }
+    }
+}
+
+// ================ INITIALIZATION ================
+
+void init_hardware(void) {
+    gpio_set_direction(PERFORMANCE_LED, GPIO_MODE_OUTPUT);
+    gpio_set_direction(HEALTH_LED, GPIO_MODE_OUTPUT);
+    gpio_set_direction(STRESS_LED, GPIO_MODE_OUTPUT);
+    gpio_set_direction(ERROR_LED, GPIO_MODE_OUTPUT);
+    
+    gpio_set_level(PERFORMANCE_LED, 0);
+    gpio_set_level(HEALTH_LED, 0);
+    gpio_set_level(STRESS_LED, 0);
+    gpio_set_level(ERROR_LED, 0);
+}
+
+void init_monitoring(void) {
+    perf_lateness_hist = lab_histogram("perf_lateness_us");
+    perf_callback_hist = lab_histogram("perf_callback_us");
+    perf_samples = lab_counter("perf_samples");
+    perf_accurate = lab_counter("perf_accurate");
+    test_result_queue = xQueueCreate(20, sizeof(uint32_t));
+    
+    timer_probe_init(&health_probe, "health");
+    timer_probe_init(&perf_probe, "perf");
+
+#if USE_DEFERRED_WORK
+    deferred_work_config_t work_config = DEFERRED_WORK_DEFAULT_CONFIG("TmrWork");
+    work_config.workers = DEFERRED_WORKERS;
+    if (!deferred_work_init(&timer_work, &work_config)) {
+        ESP_LOGE(TAG, "Failed to start deferred work executor");
+    }
+#endif
+    
+    // Reference for expiry lateness: tick number -> microsecond of its tick interrupt
+    tick_clock_sync();
+    
+    ESP_LOGI(TAG, "Monitoring systems initialized");
+}
+
+void create_system_timers(void) {
+    // Health monitor timer
+    health_monitor_timer = xTimerCreate("HealthMonitor",
+                                       pdMS_TO_TICKS(HEALTH_CHECK_INTERVAL),
+                                       pdTRUE, // Auto-reload
+                                       (void*)1,
+                                       health_monitor_callback);
+    
+    // Performance test timer
+    performance_timer = xTimerCreate("PerfTest",
+                                    pdMS_TO_TICKS(500),
+                                    pdTRUE, // Auto-reload
+                                    (void*)2,
+                                    performance_test_callback);
+    
+    if (health_monitor_timer && performance_timer) {
+        xTimerStart(health_monitor_timer, 0);
+        xTimerStart(performance_timer, 0);
+        ESP_LOGI(TAG, "System timers started");
+    } else {
+        ESP_LOGE(TAG, "Failed to create system timers");
+    }
+}
+
+void app_main(void) {
+    ESP_LOGI(TAG, "Advanced Timer Management Lab Starting...");
+    
+    if (!timer_wheel_init()) {
+        ESP_LOGE(TAG, "Failed to start the timing wheel");
+        return;
+    }
+
+#if RUN_WHEEL_BENCHMARK
+    wheel_benchmark();
+#endif
+
+#if RUN_JITTER_SWEEP
+    timer_jitter_sweep();
+#endif
+
+    // Initialize components
+    init_hardware();
+    init_timer_pool();
+    init_monitoring();
+    create_system_timers();
+    
+    // Create analysis task
+    xTaskCreate(performance_analysis_task, "PerfAnalysis", 3072, NULL, 8, NULL);
+    
+    // Wait a bit then start stress test
+    vTaskDelay(pdMS_TO_TICKS(5000));
+    xTaskCreate(stress_test_task, "StressTest", 2048, NULL, 5, &stress_test_task_handle);
+    
+    ESP_LOGI(TAG, "🚀 Advanced Timer Management System Running");
+    ESP_LOGI(TAG, "Monitor LEDs for system status:");
+    ESP_LOGI(TAG, "  GPIO2  - Performance Warning");
+    ESP_LOGI(TAG, "  GPIO4  - Health Status");
+    ESP_LOGI(TAG, "  GPIO5  - Stress Test Activity");
+    ESP_LOGI(TAG, "  GPIO18 - Error/Memory Warning");
+}
@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/timers.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lab_metrics.h"
+#include "timer_jitter.h"
+
+static const char *TAG = "TIMER_JITTER";
+
+// ================ SWEEP TABLES ================
+
+static const uint32_t sweep_timer_counts[] = {10, 100, JITTER_MAX_TIMERS};
+static const uint32_t sweep_periods_ms[] = {10, 50, 100};
+static const UBaseType_t sweep_service_priorities[] = {1, JITTER_LOAD_PRIORITY, 15};
+static const uint32_t sweep_load_percent[] = {0, 50, 90};
+
+#define SWEEP_LEN(a) (sizeof(a) / sizeof((a)[0]))
+
+#define TICK_US             (1000000 / configTICK_RATE_HZ)
+#define LOAD_WINDOW_TICKS   10
+
+// ================ TICK CLOCK ================
+
+static int64_t clock_base_us;
+static TickType_t clock_base_tick;
+
+void tick_clock_sync(void) {
+    // Spin until the tick count changes, so the base is taken right after a tick interrupt
+    TickType_t start = xTaskGetTickCount();
+    TickType_t tick;
+    while ((tick = xTaskGetTickCount()) == start) {
+    }
+    clock_base_us = esp_timer_get_time();
+    clock_base_tick = tick;
+}
+
+uint32_t tick_clock_lateness_us(TickType_t due_tick) {
+    int64_t due_us = clock_base_us + (int64_t)(int32_t)(due_tick - clock_base_tick) * TICK_US;
+    int64_t late = esp_timer_get_time() - due_us;
+    return late > 0 ? (uint32_t)late : 0;
+}
+
+// ================ BENCHMARK STATE ================
+
+static TimerHandle_t jitter_timers[JITTER_MAX_TIMERS];
+static TimerHandle_t churn_timers[JITTER_CHURN_TIMERS];
+static lab_histogram_t *lateness_hist;
+
+static atomic_bool recording;
+static atomic_uint expiries;
+static atomic_uint cmd_sent;
+static atomic_uint cmd_failed;
+
+static volatile uint32_t load_percent;
+static volatile bool helpers_stop;
+static TaskHandle_t load_tasks[portNUM_PROCESSORS];
+static TaskHandle_t churn_task_handle;
+
+static void jitter_timer_callback(TimerHandle_t timer) {
+    // Auto-reload timers are re-armed before the callback runs, so the due tick is one period back
+    TickType_t due = xTimerGetExpiryTime(timer) - xTimerGetPeriod(timer);
+    uint32_t late = tick_clock_lateness_us(due);
+    if (atomic_load_explicit(&recording, memory_order_relaxed)) {
+        lab_hist_record(lateness_hist, late);
+        atomic_fetch_add_explicit(&expiries, 1, memory_order_relaxed);
+    }
+}
+
+static void churn_timer_callback(TimerHandle_t timer) {
+    // Never expires while the churn task keeps resetting it
+}
+
+// Busy for load_percent of every LOAD_WINDOW_TICKS, asleep for the rest
+static void jitter_load_task(void *parameter) {
+    while (!helpers_stop) {
+        uint32_t percent = load_percent;
+        int64_t busy_until = esp_timer_get_time() + (int64_t)LOAD_WINDOW_TICKS * TICK_US * percent / 100;
+        while (esp_timer_get_time() < busy_until) {
+        }
+        TickType_t rest = LOAD_WINDOW_TICKS - (LOAD_WINDOW_TICKS * percent) / 100;
+        vTaskDelay(rest > 0 ? rest : 1);
+    }
+    vTaskDelete(NULL);
+}
+
+// Background command traffic: a full command queue makes these fail rather than block
+static void jitter_churn_task(void *parameter) {
+    while (!helpers_stop) {
+        for (int i = 0; i < JITTER_CHURN_TIMERS; i++) {
+            bool ok = xTimerReset(churn_timers[i], 0) == pdPASS;
+            if (atomic_load_explicit(&recording, memory_order_relaxed)) {
+                atomic_fetch_add_explicit(ok ? &cmd_sent : &cmd_failed, 1, memory_order_relaxed);
+            }
+        }
+        vTaskDelay(1);
+    }
+    vTaskDelete(NULL);
+}
+
+// Runs in the timer service task once every command queued before it is done
+static void queue_marker(void *task, uint32_t unused) {
+    xTaskNotifyGive((TaskHandle_t)task);
+}
+
+static void drain_command_queue(void) {
+    xTimerPendFunctionCall(queue_marker, xTaskGetCurrentTaskHandle(), 0, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+// ================ SWEEP ================
+
+static bool jitter_setup(void) {
+    lateness_hist = lab_histogram("timer_lateness_us");
+    if (lateness_hist == NULL) {
+        return false;
+    }
+    for (int i = 0; i < JITTER_MAX_TIMERS; i++) {
+        jitter_timers[i] = xTimerCreate("Jitter", 1, pdTRUE, NULL, jitter_timer_callback);
+        if (jitter_timers[i] == NULL) {
+            return false;
+        }
+    }
+    for (int i = 0; i < JITTER_CHURN_TIMERS; i++) {
+        churn_timers[i] = xTimerCreate("Churn", pdMS_TO_TICKS(60000), pdFALSE, NULL, churn_timer_callback);
+        if (churn_timers[i] == NULL) {
+            return false;
+        }
+    }
+
+    helpers_stop = false;
+    load_percent = 0;
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        if (xTaskCreatePinnedToCore(jitter_load_task, "JitterLoad", 2048, NULL,
+                                    JITTER_LOAD_PRIORITY, &load_tasks[core], core) != pdPASS) {
+            return false;
+        }
+    }
+    return xTaskCreate(jitter_churn_task, "JitterChurn", 2048, NULL,
+                       JITTER_CHURN_PRIORITY, &churn_task_handle) == pdPASS;
+}
+
+static void jitter_teardown(void) {
+    helpers_stop = true;
+    vTaskDelay(pdMS_TO_TICKS(200));     // helpers exit at their next wake-up
+    for (int i = 0; i < JITTER_MAX_TIMERS; i++) {
+        if (jitter_timers[i] != NULL) {
+            xTimerDelete(jitter_timers[i], portMAX_DELAY);
+            jitter_timers[i] = NULL;
+        }
+    }
+    for (int i = 0; i < JITTER_CHURN_TIMERS; i++) {
+        if (churn_timers[i] != NULL) {
+            xTimerDelete(churn_timers[i], portMAX_DELAY);
+            churn_timers[i] = NULL;
+        }
+    }
+    drain_command_queue();
+}
+
+static void jitter_run(uint32_t run, uint32_t count, uint32_t period_ms,
+                       UBaseType_t service_priority, uint32_t load) {
+    TickType_t period = pdMS_TO_TICKS(period_ms);
+    if (period == 0) {
+        period = 1;
+    }
+
+    tick_clock_sync();
+    for (uint32_t i = 0; i < count; i++) {
+        xTimerChangePeriod(jitter_timers[i], period, portMAX_DELAY);    // also starts it
+    }
+    drain_command_queue();
+
+    lab_hist_reset(lateness_hist);
+    atomic_store(&expiries, 0);
+    atomic_store(&cmd_sent, 0);
+    atomic_store(&cmd_failed, 0);
+    atomic_store(&recording, true);
+    vTaskDelay(pdMS_TO_TICKS(JITTER_RUN_MS));
+    atomic_store(&recording, false);
+
+    for (uint32_t i = 0; i < count; i++) {
+        xTimerStop(jitter_timers[i], portMAX_DELAY);
+    }
+    drain_command_queue();
+
+    lab_hist_summary_t s;
+    lab_hist_summary(lateness_hist, &s);
+    uint32_t expected = count * (pdMS_TO_TICKS(JITTER_RUN_MS) / period);
+
+    printf("S,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%u,%u\n",
+           (unsigned long)run, (unsigned long)count, (unsigned long)(period * portTICK_PERIOD_MS),
+           (unsigned long)service_priority, (unsigned long)load, (unsigned long)configTIMER_QUEUE_LENGTH,
+           (unsigned long)atomic_load(&expiries), (unsigned long)expected,
+           (unsigned long)s.mean, (unsigned long)s.p50, (unsigned long)s.p90,
+           (unsigned long)s.p99, (unsigned long)s.max,
+           atomic_load(&cmd_sent), atomic_load(&cmd_failed));
+    for (uint32_t i = 0; i < LAB_HIST_BUCKETS; i++) {
+        uint32_t n = atomic_load_explicit(&lateness_hist->buckets[i], memory_order_relaxed);
+        if (n > 0) {
+            printf("H,%lu,%lu,%lu\n", (unsigned long)run,
+                   (unsigned long)lab_hist_bucket_upper(i), (unsigned long)n);
+        }
+    }
+}
+
+void timer_jitter_sweep(void) {
+    TaskHandle_t service = xTimerGetTimerDaemonTaskHandle();
+    UBaseType_t service_priority = uxTaskPriorityGet(service);
+    UBaseType_t own_priority = uxTaskPriorityGet(NULL);
+
+    // Above the load so the sweep itself keeps to its schedule
+    vTaskPrioritySet(NULL, configMAX_PRIORITIES - 1);
+
+    if (!jitter_setup()) {
+        ESP_LOGE(TAG, "Not enough memory for the jitter sweep");
+        jitter_teardown();
+        vTaskPrioritySet(NULL, own_priority);
+        return;
+    }
+
+    uint32_t runs = SWEEP_LEN(sweep_service_priorities) * SWEEP_LEN(sweep_load_percent) *
+                    SWEEP_LEN(sweep_timer_counts) * SWEEP_LEN(sweep_periods_ms);
+    ESP_LOGI(TAG, "Sweeping %lu configurations, %d ms each (tick %d us, queue length %d)",
+             (unsigned long)runs, JITTER_RUN_MS, TICK_US, configTIMER_QUEUE_LENGTH);
+
+    printf("#TIMER_JITTER v1 tick_us=%d queue_len=%d run_ms=%d\n", TICK_US, configTIMER_QUEUE_LENGTH, JITTER_RUN_MS);
+    printf("S,run,timers,period_ms,service_prio,load_pct,queue_len,expiries,expected,"
+           "mean_us,p50_us,p90_us,p99_us,max_us,cmd_sent,cmd_failed\n");
+    printf("H,run,upper_us,count\n");
+
+    uint32_t run = 0;
+    for (size_t p = 0; p < SWEEP_LEN(sweep_service_priorities); p++) {
+        vTaskPrioritySet(service, sweep_service_priorities[p]);
+        for (size_t l = 0; l < SWEEP_LEN(sweep_load_percent); l++) {
+            load_percent = sweep_load_percent[l];
+            for (size_t c = 0; c < SWEEP_LEN(sweep_timer_counts); c++) {
+                for (size_t t = 0; t < SWEEP_LEN(sweep_periods_ms); t++) {
+                    jitter_run(run++, sweep_timer_counts[c], sweep_periods_ms[t],
+                               sweep_service_priorities[p], sweep_load_percent[l]);
+                }
+            }
+        }
+    }
+    printf("#TIMER_JITTER END\n");
+
+    load_percent = 0;
+    vTaskPrioritySet(service, service_priority);
+    jitter_teardown();
+    vTaskPrioritySet(NULL, own_priority);
+}
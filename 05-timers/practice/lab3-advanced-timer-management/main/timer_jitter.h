@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+
+/*
+ * Software-timer expiry lateness.
+ *
+ * The tick clock maps a tick number to the microsecond its tick interrupt
+ * happened: tick_clock_sync() waits for the tick count to change and stores
+ * (tick, esp_timer_get_time()) as a base, and later ticks are extrapolated
+ * from it at configTICK_RATE_HZ. A timer callback's lateness is then the time
+ * from the start of its due tick to the moment the callback runs, which
+ * covers timer-service scheduling delay and callbacks queued ahead of it.
+ *
+ * timer_jitter_sweep() measures that lateness as a histogram for every
+ * combination of timer count, period, timer service task priority and CPU
+ * load (see the tables in timer_jitter.c), with background command traffic
+ * so the command queue length shows up in the results, and prints CSV:
+ *
+ *   S,run,timers,period_ms,service_prio,load_pct,queue_len,...  one row per run
+ *   H,run,upper_us,count                                        non-empty histogram buckets
+ *
+ * The command queue length is fixed at build time (CONFIG_FREERTOS_TIMER_QUEUE_LENGTH),
+ * so it is a column: sweep it by rebuilding and concatenating the CSVs.
+ */
+
+#define JITTER_RUN_MS           1000    // measurement window per configuration
+#define JITTER_MAX_TIMERS       500
+#define JITTER_LOAD_PRIORITY    5       // busy-loop tasks, one per core
+#define JITTER_CHURN_PRIORITY   5       // task issuing xTimerReset commands every tick
+#define JITTER_CHURN_TIMERS     8       // commands per tick
+
+// Takes the tick/microsecond base; call from a task that is not preempted for long
+void tick_clock_sync(void);
+
+// Microseconds between the start of due_tick and now (0 if not yet due)
+uint32_t tick_clock_lateness_us(TickType_t due_tick);
+
+// Runs the whole sweep (about two minutes with the default tables) and prints the CSV; returns when done
+void timer_jitter_sweep(void);
@@ -0,0 +1,214 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/timers.h"
+#include "esp_timer.h"
+#include "timer_wheel.h"
+
+#define SLOTS       (1u << TIMER_WHEEL_SLOT_BITS)
+#define SLOT_MASK   (SLOTS - 1)
+
+static struct {
+    wheel_node_t slots[TIMER_WHEEL_LEVELS][SLOTS];
+    uint32_t now;               // next tick to process
+    portMUX_TYPE mux;
+    TimerHandle_t driver;
+    timer_wheel_stats_t stats;
+} wheel = {
+    .mux = portMUX_INITIALIZER_UNLOCKED,
+};
+
+// ================ LIST HELPERS (caller holds wheel.mux) ================
+
+static void list_init(wheel_node_t *head) {
+    head->next = head;
+    head->prev = head;
+}
+
+static bool list_empty(const wheel_node_t *head) {
+    return head->next == head;
+}
+
+static void list_add_tail(wheel_node_t *head, wheel_node_t *node) {
+    node->prev = head->prev;
+    node->next = head;
+    head->prev->next = node;
+    head->prev = node;
+}
+
+static void list_del(wheel_node_t *node) {
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+// Moves every node of src onto the empty list dst in O(1)
+static void list_move_all(wheel_node_t *src, wheel_node_t *dst) {
+    if (list_empty(src)) {
+        list_init(dst);
+        return;
+    }
+    dst->next = src->next;
+    dst->prev = src->prev;
+    dst->next->prev = dst;
+    dst->prev->next = dst;
+    list_init(src);
+}
+
+// ================ WHEEL ================
+
+// Links the timer into the slot matching its remaining delay; caller holds wheel.mux
+static void wheel_add_locked(wheel_timer_t *timer) {
+    int32_t delta = (int32_t)(timer->expires - wheel.now);
+    wheel_node_t *slot;
+
+    if (delta < 0) {
+        // Already due: run it with the next tick processed
+        slot = &wheel.slots[0][wheel.now & SLOT_MASK];
+    } else {
+        if ((uint32_t)delta > TIMER_WHEEL_MAX_DELAY) {
+            timer->expires = wheel.now + TIMER_WHEEL_MAX_DELAY;
+            delta = TIMER_WHEEL_MAX_DELAY;
+        }
+        int level = 0;
+        while (level < TIMER_WHEEL_LEVELS - 1 &&
+               (uint32_t)delta >= (1u << (TIMER_WHEEL_SLOT_BITS * (level + 1)))) {
+            level++;
+        }
+        slot = &wheel.slots[level][(timer->expires >> (TIMER_WHEEL_SLOT_BITS * level)) & SLOT_MASK];
+    }
+    list_add_tail(slot, &timer->node);
+}
+
+// Re-files every timer of one upper-level slot; the lock is dropped between
+// timers so a full slot never becomes one long critical section
+static void wheel_cascade(int level, uint32_t index) {
+    wheel_node_t pending;
+
+    taskENTER_CRITICAL(&wheel.mux);
+    list_move_all(&wheel.slots[level][index], &pending);
+    while (!list_empty(&pending)) {
+        wheel_timer_t *timer = (wheel_timer_t *)pending.next;
+        list_del(&timer->node);
+        wheel_add_locked(timer);
+        wheel.stats.cascaded++;
+        taskEXIT_CRITICAL(&wheel.mux);
+        taskENTER_CRITICAL(&wheel.mux);
+    }
+    taskEXIT_CRITICAL(&wheel.mux);
+}
+
+// Processes one tick: cascade on level-0 wrap, then run the current slot
+static void wheel_process_tick(void) {
+    uint32_t index = wheel.now & SLOT_MASK;
+    wheel_node_t expired;
+
+    if (index == 0) {
+        for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+            uint32_t upper = (wheel.now >> (TIMER_WHEEL_SLOT_BITS * level)) & SLOT_MASK;
+            wheel_cascade(level, upper);
+            if (upper != 0) {
+                break;
+            }
+        }
+    }
+
+    taskENTER_CRITICAL(&wheel.mux);
+    list_move_all(&wheel.slots[0][index], &expired);
+    wheel.now++;
+    while (!list_empty(&expired)) {
+        wheel_timer_t *timer = (wheel_timer_t *)expired.next;
+        list_del(&timer->node);
+        if (timer->period != 0) {
+            timer->expires += timer->period;    // drift-free: relative to the due tick
+            wheel_add_locked(timer);
+        } else {
+            wheel.stats.active--;
+        }
+        wheel.stats.expired++;
+        taskEXIT_CRITICAL(&wheel.mux);
+
+        timer->callback(timer);
+
+        taskENTER_CRITICAL(&wheel.mux);
+    }
+    taskEXIT_CRITICAL(&wheel.mux);
+}
+
+static void wheel_driver_callback(TimerHandle_t driver) {
+    int64_t start = esp_timer_get_time();
+    TickType_t now = xTaskGetTickCount();
+
+    // Catch up if the timer service task was held off for more than a tick
+    while ((int32_t)(now - wheel.now) >= 0) {
+        if (wheel.now != now) {
+            wheel.stats.late_ticks++;
+        }
+        wheel_process_tick();
+    }
+
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+    if (elapsed > wheel.stats.max_advance_us) {
+        wheel.stats.max_advance_us = elapsed;
+    }
+}
+
+bool timer_wheel_init(void) {
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (uint32_t i = 0; i < SLOTS; i++) {
+            list_init(&wheel.slots[level][i]);
+        }
+    }
+    wheel.now = xTaskGetTickCount();
+
+    wheel.driver = xTimerCreate("TimerWheel", 1, pdTRUE, NULL, wheel_driver_callback);
+    if (wheel.driver == NULL || xTimerStart(wheel.driver, portMAX_DELAY) != pdPASS) {
+        return false;
+    }
+    return true;
+}
+
+void wheel_timer_init(wheel_timer_t *timer, wheel_callback_t callback, void *arg) {
+    timer->node.next = NULL;
+    timer->node.prev = NULL;
+    timer->expires = 0;
+    timer->period = 0;
+    timer->callback = callback;
+    timer->arg = arg;
+}
+
+void wheel_timer_start(wheel_timer_t *timer, TickType_t delay, TickType_t period) {
+    if (delay > TIMER_WHEEL_MAX_DELAY) {
+        delay = TIMER_WHEEL_MAX_DELAY;
+    }
+    if (period > TIMER_WHEEL_MAX_DELAY) {
+        period = TIMER_WHEEL_MAX_DELAY;
+    }
+    TickType_t now = xTaskGetTickCount();
+
+    taskENTER_CRITICAL(&wheel.mux);
+    if (timer->node.next != NULL) {
+        list_del(&timer->node);
+    } else {
+        wheel.stats.active++;
+    }
+    timer->expires = now + delay;
+    timer->period = period;
+    wheel_add_locked(timer);
+    taskEXIT_CRITICAL(&wheel.mux);
+}
+
+void wheel_timer_stop(wheel_timer_t *timer) {
+    taskENTER_CRITICAL(&wheel.mux);
+    if (timer->node.next != NULL) {
+        list_del(&timer->node);
+        wheel.stats.active--;
+    }
+    taskEXIT_CRITICAL(&wheel.mux);
+}
+
+void timer_wheel_get_stats(timer_wheel_stats_t *stats) {
+    taskENTER_CRITICAL(&wheel.mux);
+    *stats = wheel.stats;
+    taskEXIT_CRITICAL(&wheel.mux);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+
+/*
+ * Hierarchical timing wheel driven by one periodic FreeRTOS timer.
+ *
+ * Four levels of 64 slots cover delays up to 2^24 ticks. A timer is linked
+ * into the slot of the level that matches its remaining delay, so start and
+ * stop are a couple of pointer updates under the wheel's spinlock: no timer
+ * command queue, no sorted list, no blocking. Once per tick the driving
+ * FreeRTOS timer runs the current level-0 slot, and every 64 ticks it moves
+ * the next slot of the level above down into the finer levels (cascade).
+ *
+ * Callbacks run in the timer service task, like native timer callbacks, and
+ * must not block. Resolution is one RTOS tick. wheel_timer_t is owned by the
+ * caller (usually static); nothing here allocates after timer_wheel_init().
+ * Start/stop are for task context; they may be called from a callback.
+ */
+
+#define TIMER_WHEEL_SLOT_BITS   6
+#define TIMER_WHEEL_LEVELS      4
+#define TIMER_WHEEL_MAX_DELAY   ((1u << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS)) - 1)
+
+typedef struct wheel_node {
+    struct wheel_node *next;    // NULL while the timer is idle
+    struct wheel_node *prev;
+} wheel_node_t;
+
+typedef struct wheel_timer wheel_timer_t;
+typedef void (*wheel_callback_t)(wheel_timer_t *timer);
+
+struct wheel_timer {
+    wheel_node_t node;          // must stay first: slot lists link timers through it
+    uint32_t expires;           // absolute tick of the next expiry
+    uint32_t period;            // reload in ticks, 0 = one-shot
+    wheel_callback_t callback;
+    void *arg;                  // free for the owner, like a native timer ID
+};
+
+typedef struct {
+    uint32_t active;            // timers currently linked into the wheel
+    uint32_t expired;           // callbacks run
+    uint32_t cascaded;          // timers moved down a level
+    uint32_t late_ticks;        // ticks processed late (driving timer was delayed)
+    uint32_t max_advance_us;    // longest single run of the driving timer callback
+} timer_wheel_stats_t;
+
+// Creates and starts the driving timer; false if it could not be created
+bool timer_wheel_init(void);
+
+void wheel_timer_init(wheel_timer_t *timer, wheel_callback_t callback, void *arg);
+
+// (Re)arms the timer to fire after delay ticks, then every period ticks (0 = once)
+void wheel_timer_start(wheel_timer_t *timer, TickType_t delay, TickType_t period);
+
+// Disarms the timer; a callback already running is not waited for
+void wheel_timer_stop(wheel_timer_t *timer);
+
+static inline bool wheel_timer_is_active(const wheel_timer_t *timer) { return timer->node.next != NULL; }
+
+void timer_wheel_get_stats(timer_wheel_stats_t *stats);
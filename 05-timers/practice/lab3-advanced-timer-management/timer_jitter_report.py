@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""CSV files and a p99 table from a timer jitter sweep.
+
+Reads one or more captured monitor logs (idf.py monitor | tee jitter_q10.log),
+one per CONFIG_FREERTOS_TIMER_QUEUE_LENGTH build, and writes the "S," rows to
+jitter_summary.csv and the "H," histogram rows to jitter_hist.csv. It then
+prints the worst p99 lateness and the failed-command count per
+(queue length, service priority, CPU load).
+
+    python3 timer_jitter_report.py jitter_q10.log jitter_q20.log
+"""
+import argparse
+import collections
+import csv
+import sys
+
+SUMMARY_FIELDS = ["run", "timers", "period_ms", "service_prio", "load_pct", "queue_len", "expiries",
+                  "expected", "mean_us", "p50_us", "p90_us", "p99_us", "max_us", "cmd_sent", "cmd_failed"]
+
+
+def read_log(path):
+    """Rows of the last complete #TIMER_JITTER block in the log."""
+    summary, hist, current = [], [], None
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith("#TIMER_JITTER END"):
+                if current:
+                    summary, hist = current
+                current = None
+            elif line.startswith("#TIMER_JITTER"):
+                current = ([], [])
+            elif current and line.startswith("S,") and not line.startswith("S,run"):
+                current[0].append(dict(zip(SUMMARY_FIELDS, map(int, line[2:].split(",")))))
+            elif current and line.startswith("H,") and not line.startswith("H,run"):
+                current[1].append(list(map(int, line[2:].split(","))))
+    return summary, hist
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("logs", nargs="+", help="monitor logs containing a #TIMER_JITTER block")
+    ap.add_argument("--summary", default="jitter_summary.csv")
+    ap.add_argument("--hist", default="jitter_hist.csv")
+    args = ap.parse_args()
+
+    rows, hist_rows = [], []
+    for path in args.logs:
+        summary, hist = read_log(path)
+        if not summary:
+            print(f"{path}: no complete #TIMER_JITTER block", file=sys.stderr)
+            continue
+        queue_len = {r["run"]: r["queue_len"] for r in summary}
+        rows += summary
+        hist_rows += [[queue_len[run], run, upper, count] for run, upper, count in hist]
+    if not rows:
+        sys.exit("nothing to report")
+
+    with open(args.summary, "w", newline="") as f:
+        writer = csv.DictWriter(f, fieldnames=SUMMARY_FIELDS)
+        writer.writeheader()
+        writer.writerows(rows)
+    with open(args.hist, "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(["queue_len", "run", "upper_us", "count"])
+        writer.writerows(hist_rows)
+
+    worst = collections.defaultdict(lambda: [0, 0])
+    for r in rows:
+        key = (r["queue_len"], r["service_prio"], r["load_pct"])
+        worst[key][0] = max(worst[key][0], r["p99_us"])
+        worst[key][1] += r["cmd_failed"]
+    print(f"{len(rows)} runs -> {args.summary}, {args.hist}")
+    print(f"{'queue':>5} {'prio':>4} {'load%':>5} {'worst p99 us':>12} {'cmd failed':>10}")
+    for (queue_len, prio, load), (p99, failed) in sorted(worst.items()):
+        print(f"{queue_len:>5} {prio:>4} {load:>5} {p99:>12} {failed:>10}")
+
+
+if __name__ == "__main__":
+    main()
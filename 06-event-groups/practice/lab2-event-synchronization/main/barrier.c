@@ -0,0 +1,119 @@
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "barrier.h"
+
+struct barrier_waiter {
+    TaskHandle_t task;
+    barrier_waiter_t *next;
+    volatile bool released;     // set by the releasing task just before its notification
+};
+
+void barrier_init(barrier_t *barrier, uint32_t parties, uint32_t spin_us) {
+    barrier->parties = parties > 0 ? parties : 1;
+    barrier->arrived = 0;
+    barrier->generation = 0;
+    barrier->spin_us = spin_us;
+    barrier->waiters = NULL;
+    barrier->mux = (portMUX_TYPE)portMUX_INITIALIZER_UNLOCKED;
+    atomic_init(&barrier->released_spinning, 0);
+    atomic_init(&barrier->released_blocked, 0);
+    atomic_init(&barrier->timeouts, 0);
+}
+
+// Wakes every task that blocked in the generation that just ended
+static void barrier_release(barrier_waiter_t *waiter) {
+    while (waiter != NULL) {
+        barrier_waiter_t *next = waiter->next;
+        TaskHandle_t task = waiter->task;
+        waiter->released = true;    // the node lives on the waiter's stack: no access after this
+        xTaskNotifyGive(task);
+        waiter = next;
+    }
+}
+
+// Removes a timed-out waiter; only valid while its generation is still open
+static void barrier_unlink_locked(barrier_t *barrier, barrier_waiter_t *node) {
+    barrier_waiter_t **link = &barrier->waiters;
+    while (*link != NULL && *link != node) {
+        link = &(*link)->next;
+    }
+    if (*link == node) {
+        *link = node->next;
+    }
+}
+
+barrier_result_t barrier_wait(barrier_t *barrier, TickType_t timeout) {
+    taskENTER_CRITICAL(&barrier->mux);
+    uint32_t generation = barrier->generation;
+    if (++barrier->arrived == barrier->parties) {
+        // Last to arrive: open the next generation, then wake this one
+        barrier_waiter_t *waiters = barrier->waiters;
+        barrier->waiters = NULL;
+        barrier->arrived = 0;
+        barrier->generation = generation + 1;
+        taskEXIT_CRITICAL(&barrier->mux);
+        barrier_release(waiters);
+        return BARRIER_SERIAL;
+    }
+    taskEXIT_CRITICAL(&barrier->mux);
+
+    // Spin phase: the other parties may be about to arrive on the other core
+    if (barrier->spin_us > 0) {
+        int64_t spin_until = esp_timer_get_time() + barrier->spin_us;
+        while (barrier->generation == generation && esp_timer_get_time() < spin_until) {
+        }
+        if (barrier->generation != generation) {
+            atomic_fetch_add_explicit(&barrier->released_spinning, 1, memory_order_relaxed);
+            return BARRIER_PASSED;
+        }
+    }
+
+    // Block phase
+    barrier_waiter_t node = {
+        .task = xTaskGetCurrentTaskHandle(),
+        .next = NULL,
+        .released = false,
+    };
+    taskENTER_CRITICAL(&barrier->mux);
+    if (barrier->generation != generation) {
+        taskEXIT_CRITICAL(&barrier->mux);
+        atomic_fetch_add_explicit(&barrier->released_spinning, 1, memory_order_relaxed);
+        return BARRIER_PASSED;
+    }
+    node.next = barrier->waiters;
+    barrier->waiters = &node;
+    taskEXIT_CRITICAL(&barrier->mux);
+
+    TickType_t start = xTaskGetTickCount();
+    while (1) {
+        TickType_t remaining = portMAX_DELAY;
+        if (timeout != portMAX_DELAY) {
+            TickType_t waited = xTaskGetTickCount() - start;
+            remaining = waited < timeout ? timeout - waited : 0;
+        }
+
+        if (remaining == 0) {
+            taskENTER_CRITICAL(&barrier->mux);
+            if (barrier->generation == generation) {
+                barrier_unlink_locked(barrier, &node);
+                barrier->arrived--;
+                taskEXIT_CRITICAL(&barrier->mux);
+                atomic_fetch_add_explicit(&barrier->timeouts, 1, memory_order_relaxed);
+                return BARRIER_TIMEOUT;
+            }
+            taskEXIT_CRITICAL(&barrier->mux);
+            // Released while timing out: the releaser still holds our node, wait for it
+            remaining = portMAX_DELAY;
+        }
+        // Return only once the releaser's own notification has been taken, so no give can
+        // still be on its way to this task (which may delete itself right after the wait)
+        if (ulTaskNotifyTake(pdTRUE, remaining) > 0 && node.released) {
+            break;
+        }
+    }
+
+    atomic_fetch_add_explicit(&barrier->released_blocked, 1, memory_order_relaxed);
+    return BARRIER_PASSED;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/*
+ * Reusable barrier for any number of tasks.
+ *
+ * An event group barrier needs one bit per participant, so it stops at 24
+ * tasks. Here each wait takes a ticket from a generation counter instead: the
+ * last task to arrive advances the generation, resets the count for the next
+ * round and wakes the tasks blocked on this one. A task can go straight back
+ * into barrier_wait() for the next round.
+ *
+ * With spin_us > 0 a waiter first polls the generation for up to spin_us
+ * before it blocks. When the other participants run on the other core and
+ * arrive within that window, the wake-up costs no context switch; on one
+ * core spinning only delays the others, so keep spin_us 0 there.
+ *
+ * Blocked waiters are linked through nodes on their own stacks and woken
+ * with a direct-to-task notification, so the barrier needs no storage per
+ * participant. A blocked waiter returns only after taking that notification,
+ * so a task may delete itself right after barrier_wait(). Do not give
+ * participants other notifications: one arriving during a release could be
+ * taken in place of the barrier's.
+ */
+
+typedef struct barrier_waiter barrier_waiter_t;
+
+typedef struct {
+    uint32_t parties;
+    uint32_t arrived;               // in the current generation
+    volatile uint32_t generation;   // read without the lock while spinning
+    uint32_t spin_us;
+    barrier_waiter_t *waiters;      // blocked in the current generation
+    portMUX_TYPE mux;
+
+    atomic_uint released_spinning;  // waits that ended during the spin phase
+    atomic_uint released_blocked;   // waits that ended after blocking
+    atomic_uint timeouts;
+} barrier_t;
+
+typedef enum {
+    BARRIER_PASSED = 0,
+    BARRIER_SERIAL,                 // this task arrived last and released the others
+    BARRIER_TIMEOUT,                // gave up; the round still needs all parties
+} barrier_result_t;
+
+void barrier_init(barrier_t *barrier, uint32_t parties, uint32_t spin_us);
+
+// Waits until parties tasks have arrived in this generation
+barrier_result_t barrier_wait(barrier_t *barrier, TickType_t timeout);
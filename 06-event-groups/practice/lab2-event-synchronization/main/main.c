@@ -0,0 +1,716 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "barrier.h"
+
+static const char *TAG = "EVENT_SYNC";
+
+// GPIO สำหรับแสดงสถานะ
+#define LED_BARRIER_SYNC    GPIO_NUM_2   // Barrier synchronization indicator
+#define LED_PIPELINE_STAGE1 GPIO_NUM_4   // Pipeline stage 1
+#define LED_PIPELINE_STAGE2 GPIO_NUM_5   // Pipeline stage 2  
+#define LED_PIPELINE_STAGE3 GPIO_NUM_18  // Pipeline stage 3
+#define LED_WORKFLOW_ACTIVE GPIO_NUM_19  // Workflow processing
+
+// Event Groups สำหรับการ synchronization
+EventGroupHandle_t pipeline_events;
+EventGroupHandle_t workflow_events;
+
+// Barrier Synchronization (generation-counter barrier, not limited to 24 event bits)
+#define BARRIER_WORKERS     4
+#define BARRIER_SPIN_US     0       // workers arrive seconds apart, spinning would not help
+static barrier_t worker_barrier;
+
+// Round-trip cost of xEventGroupSync vs barrier_t as participants grow, before the lab starts
+#define RUN_BARRIER_BENCHMARK   1
+#define BARRIER_BENCH_ROUNDS    500
+#define BARRIER_BENCH_SPIN_US   50
+#define BARRIER_BENCH_MAX_TASKS 48
+
+// Pipeline Processing Events
+#define STAGE1_COMPLETE_BIT (1 << 0)
+#define STAGE2_COMPLETE_BIT (1 << 1)
+#define STAGE3_COMPLETE_BIT (1 << 2)
+#define STAGE4_COMPLETE_BIT (1 << 3)
+#define DATA_AVAILABLE_BIT  (1 << 4)
+#define PIPELINE_RESET_BIT  (1 << 5)
+
+// Workflow Management Events
+#define WORKFLOW_START_BIT  (1 << 0)
+#define APPROVAL_READY_BIT  (1 << 1)
+#define RESOURCES_FREE_BIT  (1 << 2)
+#define QUALITY_OK_BIT      (1 << 3)
+#define WORKFLOW_DONE_BIT   (1 << 4)
+
+// Data structures
+typedef struct {
+    uint32_t worker_id;
+    uint32_t cycle_number;
+    uint32_t work_duration;
+    uint64_t timestamp;
+} worker_data_t;
+
+typedef struct {
+    uint32_t pipeline_id;
+    uint32_t stage;
+    float processing_data[4];
+    uint32_t quality_score;
+    uint64_t stage_timestamps[4];
+} pipeline_data_t;
+
+typedef struct {
+    uint32_t workflow_id;
+    char description[32];
+    uint32_t priority;
+    uint32_t estimated_duration;
+    bool requires_approval;
+} workflow_item_t;
+
+// Queues สำหรับ data passing
+QueueHandle_t pipeline_queue;
+QueueHandle_t workflow_queue;
+
+// Statistics
+typedef struct {
+    uint32_t barrier_cycles;
+    uint32_t pipeline_completions;
+    uint32_t workflow_completions;
+    uint32_t synchronization_time_max;
+    uint32_t synchronization_time_avg;
+    uint64_t total_processing_time;
+} sync_stats_t;
+
+static sync_stats_t stats = {0};
+
+// Barrier Synchronization Tasks
+void barrier_worker_task(void *pvParameters) {
+    uint32_t worker_id = (uint32_t)pvParameters;
+    uint32_t cycle = 0;
+    
+    ESP_LOGI(TAG, "🏃 Barrier Worker %lu started", (unsigned long)worker_id);
+    
+    while (1) {
+        cycle++;
+        
+        // Phase 1: Independent work
+        uint32_t work_duration = 1000 + (esp_random() % 3000); // 1-4 seconds
+        ESP_LOGI(TAG, "👷 Worker %lu: Cycle %lu - Independent work (%lu ms)", 
+                 (unsigned long)worker_id, (unsigned long)cycle, (unsigned long)work_duration);
+        
+        vTaskDelay(pdMS_TO_TICKS(work_duration));
+        
+        // Phase 2+3: Arrive and wait for all workers in one call
+        uint64_t barrier_start = esp_timer_get_time();
+        ESP_LOGI(TAG, "🚧 Worker %lu: Ready for barrier (cycle %lu)", (unsigned long)worker_id, (unsigned long)cycle);
+        barrier_result_t result = barrier_wait(&worker_barrier, pdMS_TO_TICKS(10000)); // 10 second timeout
+        
+        uint64_t barrier_end = esp_timer_get_time();
+        uint32_t barrier_time = (barrier_end - barrier_start) / 1000; // Convert to ms
+        
+        if (result != BARRIER_TIMEOUT) {
+            ESP_LOGI(TAG, "🎯 Worker %lu: Barrier passed! (waited %lu ms)", 
+                     (unsigned long)worker_id, (unsigned long)barrier_time);
+            
+            // Update statistics
+            if (barrier_time > stats.synchronization_time_max) {
+                stats.synchronization_time_max = barrier_time;
+            }
+            stats.synchronization_time_avg = 
+                (stats.synchronization_time_avg + barrier_time) / 2;
+            
+            if (result == BARRIER_SERIAL) { // Only the last arrival counts the cycle
+                stats.barrier_cycles++;
+                gpio_set_level(LED_BARRIER_SYNC, 1);
+                vTaskDelay(pdMS_TO_TICKS(200));
+                gpio_set_level(LED_BARRIER_SYNC, 0);
+            }
+            
+            // Phase 4: Synchronized work
+            ESP_LOGI(TAG, "🤝 Worker %lu: Synchronized work phase", (unsigned long)worker_id);
+            vTaskDelay(pdMS_TO_TICKS(500 + (esp_random() % 500)));
+            
+        } else {
+            ESP_LOGW(TAG, "⏰ Worker %lu: Barrier timeout!", (unsigned long)worker_id);
+        }
+        
+        // Cool down period
+        vTaskDelay(pdMS_TO_TICKS(2000));
+    }
+}
+
+// Pipeline Processing Tasks  
+void pipeline_stage_task(void *pvParameters) {
+    uint32_t stage_id = (uint32_t)pvParameters;
+    EventBits_t stage_complete_bit = (1 << stage_id);
+    EventBits_t prev_stage_bit = (stage_id > 0) ? (1 << (stage_id - 1)) : DATA_AVAILABLE_BIT;
+    
+    const char* stage_names[] = {"Input", "Processing", "Filtering", "Output"};
+    gpio_num_t stage_leds[] = {LED_PIPELINE_STAGE1, LED_PIPELINE_STAGE2, 
+                              LED_PIPELINE_STAGE3, LED_WORKFLOW_ACTIVE};
+    
+    ESP_LOGI(TAG, "🏭 Pipeline Stage %lu (%s) started", (unsigned long)stage_id, stage_names[stage_id]);
+    
+    while (1) {
+        // Wait for previous stage or data
+        ESP_LOGI(TAG, "⏳ Stage %lu: Waiting for input...", (unsigned long)stage_id);
+        EventBits_t bits = xEventGroupWaitBits(
+            pipeline_events,
+            prev_stage_bit,
+            pdTRUE,     // Clear bit after receiving
+            pdTRUE,     // Wait for the specific bit
+            portMAX_DELAY
+        );
+        
+        if (bits & prev_stage_bit) {
+            gpio_set_level(stage_leds[stage_id], 1);
+            
+            pipeline_data_t pipeline_data;
+            
+            // Get data from queue if available
+            if (xQueueReceive(pipeline_queue, &pipeline_data, pdMS_TO_TICKS(100)) == pdTRUE) {
+                ESP_LOGI(TAG, "📦 Stage %lu: Processing pipeline ID %lu", 
+                         (unsigned long)stage_id, (unsigned long)pipeline_data.pipeline_id);
+                
+                // Record processing start time
+                pipeline_data.stage_timestamps[stage_id] = esp_timer_get_time();
+                pipeline_data.stage = stage_id;
+                
+                // Simulate stage-specific processing
+                uint32_t processing_time = 500 + (esp_random() % 1000);
+                
+                switch (stage_id) {
+                    case 0: // Input stage
+                        ESP_LOGI(TAG, "📥 Stage %lu: Data input and validation", (unsigned long)stage_id);
+                        for (int i = 0; i < 4; i++) {
+                            pipeline_data.processing_data[i] = (esp_random() % 1000) / 10.0;
+                        }
+                        pipeline_data.quality_score = 70 + (esp_random() % 30);
+                        break;
+                        
+                    case 1: // Processing stage
+                        ESP_LOGI(TAG, "⚙️ Stage %lu: Data processing and transformation", (unsigned long)stage_id);
+                        for (int i = 0; i < 4; i++) {
+                            pipeline_data.processing_data[i] *= 1.1; // Apply processing
+                        }
+                        pipeline_data.quality_score += (esp_random() % 20) - 10; // ±10
+                        break;
+                        
+                    case 2: // Filtering stage
+                        ESP_LOGI(TAG, "🔍 Stage %lu: Data filtering and validation", (unsigned long)stage_id);
+                        float avg = 0;
+                        for (int i = 0; i < 4; i++) {
+                            avg += pipeline_data.processing_data[i];
+                        }
+                        avg /= 4.0;
+                        ESP_LOGI(TAG, "Average value: %.2f, Quality: %lu", 
+                                avg, (unsigned long)pipeline_data.quality_score);
+                        break;
+                        
+                    case 3: // Output stage
+                        ESP_LOGI(TAG, "📤 Stage %lu: Data output and delivery", (unsigned long)stage_id);
+                        stats.pipeline_completions++;
+                        
+                        uint64_t total_time = esp_timer_get_time() - 
+                                            pipeline_data.stage_timestamps[0];
+                        stats.total_processing_time += total_time;
+                        
+                        ESP_LOGI(TAG, "✅ Pipeline %lu completed in %llu ms (Quality: %lu)", 
+                                (unsigned long)pipeline_data.pipeline_id, total_time / 1000, 
+                                (unsigned long)pipeline_data.quality_score);
+                        break;
+                }
+                
+                vTaskDelay(pdMS_TO_TICKS(processing_time));
+                
+                // Pass data to next stage
+                if (stage_id < 3) {
+                    if (xQueueSend(pipeline_queue, &pipeline_data, pdMS_TO_TICKS(100)) == pdTRUE) {
+                        xEventGroupSetBits(pipeline_events, stage_complete_bit);
+                        ESP_LOGI(TAG, "➡️ Stage %lu: Data passed to next stage", (unsigned long)stage_id);
+                    } else {
+                        ESP_LOGW(TAG, "⚠️ Stage %lu: Queue full, data lost", (unsigned long)stage_id);
+                    }
+                }
+                
+            } else {
+                ESP_LOGW(TAG, "⚠️ Stage %lu: No data in queue", (unsigned long)stage_id);
+            }
+            
+            gpio_set_level(stage_leds[stage_id], 0);
+        }
+        
+        // Check for pipeline reset
+        EventBits_t reset_bits = xEventGroupGetBits(pipeline_events);
+        if (reset_bits & PIPELINE_RESET_BIT) {
+            ESP_LOGI(TAG, "🔄 Stage %lu: Pipeline reset detected", (unsigned long)stage_id);
+            xEventGroupClearBits(pipeline_events, PIPELINE_RESET_BIT);
+            // Clear any remaining data
+            pipeline_data_t dummy;
+            while (xQueueReceive(pipeline_queue, &dummy, 0) == pdTRUE);
+        }
+    }
+}
+
+// Pipeline data generator
+void pipeline_data_generator_task(void *pvParameters) {
+    uint32_t pipeline_id = 0;
+    
+    ESP_LOGI(TAG, "🏭 Pipeline data generator started");
+    
+    while (1) {
+        pipeline_data_t data = {0};
+        data.pipeline_id = ++pipeline_id;
+        data.stage = 0;
+        data.stage_timestamps[0] = esp_timer_get_time();
+        
+        ESP_LOGI(TAG, "🚀 Generating pipeline data ID: %lu", (unsigned long)pipeline_id);
+        
+        if (xQueueSend(pipeline_queue, &data, pdMS_TO_TICKS(1000)) == pdTRUE) {
+            xEventGroupSetBits(pipeline_events, DATA_AVAILABLE_BIT);
+            ESP_LOGI(TAG, "✅ Pipeline data %lu injected", (unsigned long)pipeline_id);
+        } else {
+            ESP_LOGW(TAG, "⚠️ Pipeline queue full, data %lu dropped", (unsigned long)pipeline_id);
+        }
+        
+        // Generate data at random intervals
+        uint32_t interval = 3000 + (esp_random() % 4000); // 3-7 seconds
+        vTaskDelay(pdMS_TO_TICKS(interval));
+    }
+}
+
+// Workflow Management Tasks
+void workflow_manager_task(void *pvParameters) {
+    ESP_LOGI(TAG, "📋 Workflow manager started");
+    
+    while (1) {
+        workflow_item_t workflow;
+        
+        // Wait for workflow requests
+        if (xQueueReceive(workflow_queue, &workflow, portMAX_DELAY) == pdTRUE) {
+            ESP_LOGI(TAG, "📝 New workflow: ID %lu - %s (Priority: %lu)", 
+                     (unsigned long)workflow.workflow_id, workflow.description, (unsigned long)workflow.priority);
+            
+            // Set workflow start event
+            xEventGroupSetBits(workflow_events, WORKFLOW_START_BIT);
+            gpio_set_level(LED_WORKFLOW_ACTIVE, 1);
+            
+            // Check workflow requirements
+            EventBits_t required_events = RESOURCES_FREE_BIT;
+            
+            if (workflow.requires_approval) {
+                required_events |= APPROVAL_READY_BIT;
+                ESP_LOGI(TAG, "📋 Workflow %lu requires approval", (unsigned long)workflow.workflow_id);
+            }
+            
+            // Wait for requirements
+            ESP_LOGI(TAG, "⏳ Waiting for workflow requirements (0x%08lX)...", (unsigned long)required_events);
+            EventBits_t bits = xEventGroupWaitBits(
+                workflow_events,
+                required_events,
+                pdFALSE,    // Don't clear bits
+                pdTRUE,     // Wait for ALL required bits
+                pdMS_TO_TICKS(workflow.estimated_duration * 2) // Dynamic timeout
+            );
+            
+            if ((bits & required_events) == required_events) {
+                ESP_LOGI(TAG, "✅ Workflow %lu: Requirements met, starting execution", 
+                         (unsigned long)workflow.workflow_id);
+                
+                // Execute workflow
+                uint32_t execution_time = workflow.estimated_duration + 
+                                        (esp_random() % 1000); // Add some randomness
+                
+                ESP_LOGI(TAG, "⚙️ Executing workflow %lu (%lu ms estimated)", 
+                         (unsigned long)workflow.workflow_id, (unsigned long)execution_time);
+                
+                vTaskDelay(pdMS_TO_TICKS(execution_time));
+                
+                // Simulate quality check
+                uint32_t quality = 60 + (esp_random() % 40); // 60-100%
+                
+                if (quality > 80) {
+                    xEventGroupSetBits(workflow_events, QUALITY_OK_BIT);
+                    ESP_LOGI(TAG, "✅ Workflow %lu completed successfully (Quality: %lu%%)", 
+                             (unsigned long)workflow.workflow_id, (unsigned long)quality);
+                    
+                    xEventGroupSetBits(workflow_events, WORKFLOW_DONE_BIT);
+                    stats.workflow_completions++;
+                    
+                } else {
+                    ESP_LOGW(TAG, "⚠️ Workflow %lu quality check failed (%lu%%), retrying...", 
+                             (unsigned long)workflow.workflow_id, (unsigned long)quality);
+                    
+                    // Re-queue for retry
+                    if (xQueueSend(workflow_queue, &workflow, 0) != pdTRUE) {
+                        ESP_LOGE(TAG, "❌ Failed to re-queue workflow %lu", (unsigned long)workflow.workflow_id);
+                    }
+                }
+                
+            } else {
+                ESP_LOGW(TAG, "⏰ Workflow %lu timeout - requirements not met", 
+                         (unsigned long)workflow.workflow_id);
+            }
+            
+            gpio_set_level(LED_WORKFLOW_ACTIVE, 0);
+            
+            // Clear workflow events for next iteration
+            xEventGroupClearBits(workflow_events, 
+                               WORKFLOW_START_BIT | WORKFLOW_DONE_BIT | QUALITY_OK_BIT);
+        }
+    }
+}
+
+// Approval task (simulates approval process)
+void approval_task(void *pvParameters) {
+    ESP_LOGI(TAG, "👨‍💼 Approval task started");
+    
+    while (1) {
+        // Wait for workflow start
+        xEventGroupWaitBits(workflow_events, WORKFLOW_START_BIT, 
+                           pdFALSE, pdTRUE, portMAX_DELAY);
+        
+        ESP_LOGI(TAG, "📋 Approval process initiated...");
+        
+        // Simulate approval time
+        uint32_t approval_time = 1000 + (esp_random() % 2000); // 1-3 seconds
+        vTaskDelay(pdMS_TO_TICKS(approval_time));
+        
+        // Random approval decision
+        bool approved = (esp_random() % 100) > 20; // 80% approval rate
+        
+        if (approved) {
+            ESP_LOGI(TAG, "✅ Approval granted (took %lu ms)", (unsigned long)approval_time);
+            xEventGroupSetBits(workflow_events, APPROVAL_READY_BIT);
+        } else {
+            ESP_LOGW(TAG, "❌ Approval denied");
+            xEventGroupClearBits(workflow_events, APPROVAL_READY_BIT);
+        }
+        
+        // Keep approval valid for a while
+        vTaskDelay(pdMS_TO_TICKS(5000));
+        xEventGroupClearBits(workflow_events, APPROVAL_READY_BIT);
+    }
+}
+
+// Resource manager task
+void resource_manager_task(void *pvParameters) {
+    ESP_LOGI(TAG, "🏗️ Resource manager started");
+    
+    bool resources_available = true;
+    
+    while (1) {
+        if (resources_available) {
+            xEventGroupSetBits(workflow_events, RESOURCES_FREE_BIT);
+            ESP_LOGI(TAG, "🟢 Resources available");
+            
+            // Simulate resource usage
+            uint32_t usage_time = 2000 + (esp_random() % 8000); // 2-10 seconds
+            vTaskDelay(pdMS_TO_TICKS(usage_time));
+            
+            // Randomly make resources unavailable
+            if ((esp_random() % 100) > 70) { // 30% chance
+                resources_available = false;
+                xEventGroupClearBits(workflow_events, RESOURCES_FREE_BIT);
+                ESP_LOGI(TAG, "🔴 Resources temporarily unavailable");
+            }
+            
+        } else {
+            ESP_LOGI(TAG, "⏳ Waiting for resources to become available...");
+            
+            // Simulate resource recovery time
+            uint32_t recovery_time = 3000 + (esp_random() % 5000); // 3-8 seconds
+            vTaskDelay(pdMS_TO_TICKS(recovery_time));
+            
+            resources_available = true;
+            ESP_LOGI(TAG, "🟢 Resources recovered and available");
+        }
+    }
+}
+
+// Workflow generator task
+void workflow_generator_task(void *pvParameters) {
+    uint32_t workflow_counter = 0;
+    
+    ESP_LOGI(TAG, "📋 Workflow generator started");
+    
+    while (1) {
+        workflow_item_t workflow = {0};
+        workflow.workflow_id = ++workflow_counter;
+        workflow.priority = 1 + (esp_random() % 5); // Priority 1-5
+        workflow.estimated_duration = 2000 + (esp_random() % 4000); // 2-6 seconds
+        workflow.requires_approval = (esp_random() % 100) > 60; // 40% need approval
+        
+        // Generate workflow description
+        const char* workflow_types[] = {
+            "Data Processing", "Report Generation", "System Backup",
+            "Quality Analysis", "Performance Test", "Security Scan"
+        };
+        
+        strcpy(workflow.description, workflow_types[esp_random() % 6]);
+        
+        ESP_LOGI(TAG, "🚀 Generated workflow: %s (ID: %lu, Priority: %lu, Approval: %s)", 
+                 workflow.description, (unsigned long)workflow.workflow_id, (unsigned long)workflow.priority,
+                 workflow.requires_approval ? "Required" : "Not Required");
+        
+        if (xQueueSend(workflow_queue, &workflow, pdMS_TO_TICKS(1000)) != pdTRUE) {
+            ESP_LOGW(TAG, "⚠️ Workflow queue full, dropping workflow %lu", (unsigned long)workflow.workflow_id);
+        }
+        
+        // Generate workflows at random intervals
+        uint32_t interval = 4000 + (esp_random() % 6000); // 4-10 seconds
+        vTaskDelay(pdMS_TO_TICKS(interval));
+    }
+}
+
+#if RUN_BARRIER_BENCHMARK
+typedef enum {
+    BENCH_EVENT_GROUP,      // xEventGroupSync, one bit per task
+    BENCH_BARRIER_BLOCK,    // barrier_t, block immediately
+    BENCH_BARRIER_SPIN,     // barrier_t, spin BARRIER_BENCH_SPIN_US then block
+} bench_mode_t;
+
+static const uint32_t bench_party_counts[] = {2, 4, 8, 16, 24, 32, BARRIER_BENCH_MAX_TASKS};
+
+static struct {
+    bench_mode_t mode;
+    uint32_t parties;
+    EventGroupHandle_t group;
+    barrier_t barrier;
+    TaskHandle_t controller;
+    int64_t first_us;       // task 0 leaving round 0
+    int64_t last_us;        // task 0 leaving the last round
+} bench;
+
+static void barrier_bench_task(void *pvParameters) {
+    uint32_t id = (uint32_t)pvParameters;
+    EventBits_t all_bits = (1UL << bench.parties) - 1;
+
+    for (uint32_t round = 0; round < BARRIER_BENCH_ROUNDS; round++) {
+        if (bench.mode == BENCH_EVENT_GROUP) {
+            xEventGroupSync(bench.group, 1UL << id, all_bits, portMAX_DELAY);
+        } else {
+            barrier_wait(&bench.barrier, portMAX_DELAY);
+        }
+        if (id == 0) {
+            bench.last_us = esp_timer_get_time();
+            if (round == 0) {
+                bench.first_us = bench.last_us;
+            }
+        }
+    }
+    xTaskNotifyGive(bench.controller);
+    vTaskDelete(NULL);
+}
+
+// Average μs per round, 0 if the tasks could not be created
+static uint32_t bench_run(bench_mode_t mode, uint32_t parties) {
+    bench.mode = mode;
+    bench.parties = parties;
+    bench.controller = xTaskGetCurrentTaskHandle();
+    barrier_init(&bench.barrier, parties, mode == BENCH_BARRIER_SPIN ? BARRIER_BENCH_SPIN_US : 0);
+    if (mode == BENCH_EVENT_GROUP) {
+        xEventGroupClearBits(bench.group, 0x00FFFFFF);
+    }
+
+    TaskHandle_t tasks[BARRIER_BENCH_MAX_TASKS];
+    uint32_t created = 0;
+    for (uint32_t i = 0; i < parties; i++) {
+        char task_name[16];
+        sprintf(task_name, "Bench%lu", (unsigned long)i);
+        if (xTaskCreate(barrier_bench_task, task_name, 2048, (void*)i, 5, &tasks[i]) != pdPASS) {
+            break;
+        }
+        created++;
+    }
+    if (created < parties) {
+        // The round can never complete: remove the tasks already waiting in it
+        ESP_LOGE(TAG, "Benchmark: only %lu of %lu tasks created, stopping", 
+                 (unsigned long)created, (unsigned long)parties);
+        for (uint32_t i = 0; i < created; i++) {
+            vTaskDelete(tasks[i]);
+        }
+        // Drop the deleted tasks' waiter nodes, which lived on their stacks
+        barrier_init(&bench.barrier, parties, 0);
+        vTaskDelay(pdMS_TO_TICKS(10)); // let the idle task free the deleted tasks
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < parties; i++) {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    }
+    vTaskDelay(pdMS_TO_TICKS(10)); // let the idle task free the deleted tasks
+    return (uint32_t)((bench.last_us - bench.first_us) / (BARRIER_BENCH_ROUNDS - 1));
+}
+
+void barrier_benchmark(void) {
+    bench.group = xEventGroupCreate();
+    if (!bench.group) {
+        ESP_LOGE(TAG, "Benchmark: failed to create event group");
+        return;
+    }
+
+    ESP_LOGI(TAG, "⏱️ Barrier round trip (%d rounds, μs/round, spin %d μs):", 
+             BARRIER_BENCH_ROUNDS, BARRIER_BENCH_SPIN_US);
+    ESP_LOGI(TAG, "  tasks | event group | barrier block | barrier spin (spun/blocked)");
+    for (size_t i = 0; i < sizeof(bench_party_counts) / sizeof(bench_party_counts[0]); i++) {
+        uint32_t parties = bench_party_counts[i];
+        uint32_t event_group_us = 0;
+        if (parties <= 24) { // EventBits_t has 24 usable bits
+            event_group_us = bench_run(BENCH_EVENT_GROUP, parties);
+            if (event_group_us == 0) {
+                break;
+            }
+        }
+        uint32_t block_us = bench_run(BENCH_BARRIER_BLOCK, parties);
+        uint32_t spin_us = bench_run(BENCH_BARRIER_SPIN, parties);
+        if (block_us == 0 || spin_us == 0) {
+            break;
+        }
+
+        char event_group_text[12] = "n/a";
+        if (parties <= 24) {
+            snprintf(event_group_text, sizeof(event_group_text), "%lu", (unsigned long)event_group_us);
+        }
+        ESP_LOGI(TAG, "  %5lu | %11s | %13lu | %12lu (%u/%u)",
+                 (unsigned long)parties, event_group_text, (unsigned long)block_us, (unsigned long)spin_us,
+                 atomic_load(&bench.barrier.released_spinning),
+                 atomic_load(&bench.barrier.released_blocked));
+    }
+    vEventGroupDelete(bench.group);
+}
+#endif
+
+// Statistics and monitoring task
+void statistics_monitor_task(void *pvParameters) {
+    ESP_LOGI(TAG, "📊 Statistics monitor started");
+    
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(15000)); // Report every 15 seconds
+        
+        ESP_LOGI(TAG, "\n📈 ═══ SYNCHRONIZATION STATISTICS ═══");
+        ESP_LOGI(TAG, "Barrier cycles:        %lu", (unsigned long)stats.barrier_cycles);
+        ESP_LOGI(TAG, "Pipeline completions:  %lu", (unsigned long)stats.pipeline_completions);
+        ESP_LOGI(TAG, "Workflow completions:  %lu", (unsigned long)stats.workflow_completions);
+        ESP_LOGI(TAG, "Max sync time:         %lu ms", (unsigned long)stats.synchronization_time_max);
+        ESP_LOGI(TAG, "Avg sync time:         %lu ms", (unsigned long)stats.synchronization_time_avg);
+        
+        if (stats.pipeline_completions > 0) {
+            uint32_t avg_pipeline_time = (stats.total_processing_time / 1000) / 
+                                       stats.pipeline_completions;
+            ESP_LOGI(TAG, "Avg pipeline time:     %lu ms", (unsigned long)avg_pipeline_time);
+        }
+        
+        ESP_LOGI(TAG, "Free heap:             %lu bytes", (unsigned long)esp_get_free_heap_size());
+        ESP_LOGI(TAG, "System uptime:         %llu ms", esp_timer_get_time() / 1000);
+        ESP_LOGI(TAG, "═══════════════════════════════════════\n");
+        
+        // Event group status
+        ESP_LOGI(TAG, "📊 Event Group Status:");
+        ESP_LOGI(TAG, "  Barrier:          generation %lu, %lu/%lu arrived, %u blocked / %u spun / %u timeouts",
+                 (unsigned long)worker_barrier.generation, (unsigned long)worker_barrier.arrived,
+                 (unsigned long)worker_barrier.parties,
+                 atomic_load(&worker_barrier.released_blocked),
+                 atomic_load(&worker_barrier.released_spinning),
+                 atomic_load(&worker_barrier.timeouts));
+        ESP_LOGI(TAG, "  Pipeline events:  0x%08lX", (unsigned long)xEventGroupGetBits(pipeline_events));
+        ESP_LOGI(TAG, "  Workflow events:  0x%08lX", (unsigned long)xEventGroupGetBits(workflow_events));
+    }
+}
+
+void app_main(void) {
+    ESP_LOGI(TAG, "🚀 Event Synchronization Lab Starting...");
+    
+    // Configure GPIO
+    gpio_set_direction(LED_BARRIER_SYNC, GPIO_MODE_OUTPUT);
+    gpio_set_direction(LED_PIPELINE_STAGE1, GPIO_MODE_OUTPUT);
+    gpio_set_direction(LED_PIPELINE_STAGE2, GPIO_MODE_OUTPUT);
+    gpio_set_direction(LED_PIPELINE_STAGE3, GPIO_MODE_OUTPUT);
+    gpio_set_direction(LED_WORKFLOW_ACTIVE, GPIO_MODE_OUTPUT);
+    
+    // Initialize all LEDs off
+    gpio_set_level(LED_BARRIER_SYNC, 0);
+    gpio_set_level(LED_PIPELINE_STAGE1, 0);
+    gpio_set_level(LED_PIPELINE_STAGE2, 0);
+    gpio_set_level(LED_PIPELINE_STAGE3, 0);
+    gpio_set_level(LED_WORKFLOW_ACTIVE, 0);
+    
+#if RUN_BARRIER_BENCHMARK
+    barrier_benchmark();
+#endif
+    
+    // Create Event Groups
+    pipeline_events = xEventGroupCreate();
+    workflow_events = xEventGroupCreate();
+    barrier_init(&worker_barrier, BARRIER_WORKERS, BARRIER_SPIN_US);
+    
+    if (!pipeline_events || !workflow_events) {
+        ESP_LOGE(TAG, "Failed to create event groups!");
+        return;
+    }
+    
+    // Create Queues
+    pipeline_queue = xQueueCreate(5, sizeof(pipeline_data_t));
+    workflow_queue = xQueueCreate(8, sizeof(workflow_item_t));
+    
+    if (!pipeline_queue || !workflow_queue) {
+        ESP_LOGE(TAG, "Failed to create queues!");
+        return;
+    }
+    
+    ESP_LOGI(TAG, "Event groups and queues created successfully");
+    
+    // Create Barrier Synchronization Tasks
+    ESP_LOGI(TAG, "Creating barrier synchronization tasks...");
+    for (int i = 0; i < BARRIER_WORKERS; i++) {
+        char task_name[16];
+        sprintf(task_name, "BarrierWork%d", i);
+        xTaskCreate(barrier_worker_task, task_name, 2048, (void*)i, 5, NULL);
+    }
+    
+    // Create Pipeline Processing Tasks
+    ESP_LOGI(TAG, "Creating pipeline processing tasks...");
+    for (int i = 0; i < 4; i++) {
+        char task_name[16];
+        sprintf(task_name, "PipeStage%d", i);
+        xTaskCreate(pipeline_stage_task, task_name, 3072, (void*)i, 6, NULL);
+    }
+    
+    xTaskCreate(pipeline_data_generator_task, "PipeGen", 2048, NULL, 4, NULL);
+    
+    // Create Workflow Management Tasks
+    ESP_LOGI(TAG, "Creating workflow management tasks...");
+    xTaskCreate(workflow_manager_task, "WorkflowMgr", 3072, NULL, 7, NULL);
+    xTaskCreate(approval_task, "Approval", 2048, NULL, 6, NULL);
+    xTaskCreate(resource_manager_task, "ResourceMgr", 2048, NULL, 6, NULL);
+    xTaskCreate(workflow_generator_task, "WorkflowGen", 2048, NULL, 4, NULL);
+    
+    // Create monitoring task
+    xTaskCreate(statistics_monitor_task, "StatsMon", 3072, NULL, 3, NULL);
+    
+    ESP_LOGI(TAG, "All tasks created successfully");
+    ESP_LOGI(TAG, "\n🎯 LED Indicators:");
+    ESP_LOGI(TAG, "  GPIO2  - Barrier Synchronization");
+    ESP_LOGI(TAG, "  GPIO4  - Pipeline Stage 1");
+    ESP_LOGI(TAG, "  GPIO5  - Pipeline Stage 2");
+    ESP_LOGI(TAG, "  GPIO18 - Pipeline Stage 3");
+    ESP_LOGI(TAG, "  GPIO19 - Workflow Active");
+    
+    ESP_LOGI(TAG, "\n🔄 System Features:");
+    ESP_LOGI(TAG, "  • Barrier Synchronization (%d workers)", BARRIER_WORKERS);
+    ESP_LOGI(TAG, "  • Pipeline Processing (4 stages)");
+    ESP_LOGI(TAG, "  • Workflow Management (approval & resources)");
+    ESP_LOGI(TAG, "  • Real-time Statistics Monitoring");
+    
+    ESP_LOGI(TAG, "Event Synchronization System operational!");
+}
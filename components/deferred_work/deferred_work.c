@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "deferred_work.h"
+
+typedef struct {
+    deferred_fn_t fn;
+    void *arg;
+    uint32_t arg2;
+    uint32_t submit_us;         // low 32 bits of esp_timer_get_time()
+} deferred_item_t;
+
+// ================ EXECUTOR ================
+
+static lab_histogram_t *named_histogram(const char *prefix, const char *suffix) {
+    char name[LAB_METRICS_NAME_LEN];
+    snprintf(name, sizeof(name), "%s_%s", prefix, suffix);
+    return lab_histogram(name);
+}
+
+static lab_counter_t *named_counter(const char *prefix, const char *suffix) {
+    char name[LAB_METRICS_NAME_LEN];
+    snprintf(name, sizeof(name), "%s_%s", prefix, suffix);
+    return lab_counter(name);
+}
+
+static void run_item(deferred_work_t *dw, const deferred_item_t *item) {
+    uint32_t start = (uint32_t)esp_timer_get_time();
+    lab_hist_record(dw->wait_us, start - item->submit_us);
+    item->fn(item->arg, item->arg2);
+    lab_hist_record(dw->run_us, (uint32_t)esp_timer_get_time() - start);
+}
+
+static void deferred_worker_task(void *parameter) {
+    deferred_work_t *dw = (deferred_work_t *)parameter;
+    deferred_item_t item;
+
+    while (1) {
+        if (xQueueReceive(dw->queue, &item, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        // One wake-up drains whatever else is already queued, up to batch_max
+        uint32_t batch = 0;
+        do {
+            run_item(dw, &item);
+            batch++;
+        } while (batch < dw->config.batch_max && xQueueReceive(dw->queue, &item, 0) == pdTRUE);
+        lab_hist_record(dw->batch, batch);
+    }
+}
+
+bool deferred_work_init(deferred_work_t *dw, const deferred_work_config_t *config) {
+    dw->config = *config;
+    if (dw->config.workers == 0) {
+        dw->config.workers = 1;
+    }
+    if (dw->config.workers > DEFERRED_WORK_MAX_WORKERS) {
+        dw->config.workers = DEFERRED_WORK_MAX_WORKERS;
+    }
+    if (dw->config.batch_max == 0) {
+        dw->config.batch_max = 1;
+    }
+
+    dw->wait_us = named_histogram(config->name, "wait_us");
+    dw->run_us = named_histogram(config->name, "run_us");
+    dw->batch = named_histogram(config->name, "batch");
+    dw->submitted = named_counter(config->name, "submitted");
+    dw->dropped = named_counter(config->name, "dropped");
+    if (!dw->wait_us || !dw->run_us || !dw->batch || !dw->submitted || !dw->dropped) {
+        return false;
+    }
+
+    dw->queue = xQueueCreate(dw->config.queue_length, sizeof(deferred_item_t));
+    if (dw->queue == NULL) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < dw->config.workers; i++) {
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "%s%lu", config->name, (unsigned long)i);
+        if (xTaskCreate(deferred_worker_task, name, dw->config.stack_size, dw,
+                        dw->config.priority, &dw->workers[i]) != pdPASS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool deferred_work_submit(deferred_work_t *dw, deferred_fn_t fn, void *arg, uint32_t arg2) {
+    deferred_item_t item = {
+        .fn = fn,
+        .arg = arg,
+        .arg2 = arg2,
+        .submit_us = (uint32_t)esp_timer_get_time(),
+    };
+    if (xQueueSend(dw->queue, &item, 0) != pdTRUE) {
+        lab_counter_inc(dw->dropped);
+        return false;
+    }
+    lab_counter_inc(dw->submitted);
+    return true;
+}
+
+void deferred_work_report(deferred_work_t *dw, const char *tag) {
+    lab_hist_summary_t wait, run, batch;
+    lab_hist_summary(dw->wait_us, &wait);
+    lab_hist_summary(dw->run_us, &run);
+    lab_hist_summary(dw->batch, &batch);
+    lab_hist_reset(dw->wait_us);
+    lab_hist_reset(dw->run_us);
+    lab_hist_reset(dw->batch);
+
+    ESP_LOGI(tag, "🧵 Deferred work '%s' (%lu workers): submitted %lu, dropped %lu, queued %lu",
+             dw->config.name, (unsigned long)dw->config.workers,
+             (unsigned long)lab_counter_read(dw->submitted), (unsigned long)lab_counter_read(dw->dropped),
+             (unsigned long)uxQueueMessagesWaiting(dw->queue));
+    ESP_LOGI(tag, "  wait p50=%luμs p99=%luμs max=%luμs | run p50=%luμs p99=%luμs max=%luμs | batch avg=%lu max=%lu",
+             (unsigned long)wait.p50, (unsigned long)wait.p99, (unsigned long)wait.max,
+             (unsigned long)run.p50, (unsigned long)run.p99, (unsigned long)run.max,
+             (unsigned long)batch.mean, (unsigned long)batch.max);
+}
+
+// ================ TIMER PROBES ================
+
+static timer_probe_t *probes[TIMER_PROBE_MAX];
+static int probe_count = 0;
+static lab_counter_t *timer_busy_us;
+static portMUX_TYPE probe_mux = portMUX_INITIALIZER_UNLOCKED;
+
+bool timer_probe_init(timer_probe_t *probe, const char *name) {
+    probe->name = name;
+    probe->runtime_us = named_histogram(name, "cb_us");
+    if (timer_busy_us == NULL) {
+        timer_busy_us = lab_counter("timer_busy_us");
+    }
+    if (probe->runtime_us == NULL || timer_busy_us == NULL) {
+        return false;
+    }
+
+    bool ok = false;
+    taskENTER_CRITICAL(&probe_mux);
+    if (probe_count < TIMER_PROBE_MAX) {
+        probes[probe_count++] = probe;
+        ok = true;
+    }
+    taskEXIT_CRITICAL(&probe_mux);
+    return ok;
+}
+
+int64_t timer_probe_begin(void) {
+    return esp_timer_get_time();
+}
+
+void timer_probe_end(timer_probe_t *probe, int64_t start) {
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+    lab_hist_record(probe->runtime_us, elapsed);
+    lab_counter_add(timer_busy_us, elapsed);
+}
+
+void timer_probe_report(const char *tag) {
+    static int64_t last_us = 0;
+    static uint32_t last_busy = 0;
+
+    if (timer_busy_us == NULL) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    uint32_t busy = lab_counter_read(timer_busy_us);
+    uint32_t window_us = last_us ? (uint32_t)(now - last_us) : (uint32_t)now;
+    uint32_t busy_us = busy - last_busy;
+    last_us = now;
+    last_busy = busy;
+
+    uint32_t permille = window_us ? (uint32_t)((uint64_t)busy_us * 1000 / window_us) : 0;
+    ESP_LOGI(tag, "⏲️ Timer service occupancy: %lu.%lu%% (%luμs of %lums in probed callbacks)",
+             (unsigned long)(permille / 10), (unsigned long)(permille % 10),
+             (unsigned long)busy_us, (unsigned long)(window_us / 1000));
+
+    for (int i = 0; i < probe_count; i++) {
+        lab_hist_summary_t s;
+        lab_hist_summary(probes[i]->runtime_us, &s);
+        lab_hist_reset(probes[i]->runtime_us);
+        ESP_LOGI(tag, "  %-12s callbacks %4lu | p50=%luμs p99=%luμs max=%luμs",
+                 probes[i]->name, (unsigned long)s.count,
+                 (unsigned long)s.p50, (unsigned long)s.p99, (unsigned long)s.max);
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "lab_metrics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Deferred-work executor for timer callbacks.
+ *
+ * Everything a software timer callback does runs in the single timer service
+ * task, so one slow callback delays every other timer's expiry. Instead the
+ * callback submits a small work item (function + two arguments, the same
+ * shape as xTimerPendFunctionCall) and returns; a pool of worker tasks takes
+ * items from a queue and runs them. A worker that wakes up keeps running
+ * queued items, up to batch_max, before blocking again.
+ *
+ * deferred_work_submit() never blocks: when the queue is full the item is
+ * dropped and counted, so the timer service task is never held up.
+ *
+ * Per executor metrics (lab_metrics, prefixed with the executor name):
+ * <name>_wait_us (submit -> start), <name>_run_us, <name>_batch,
+ * and <name>_submitted / <name>_dropped counters.
+ *
+ * Timer probes measure the callbacks themselves: wrap a callback body in
+ * timer_probe_begin()/timer_probe_end() to get its runtime histogram
+ * (<name>_cb_us) and to add the time to the timer service busy total, from
+ * which timer_probe_report() derives timer service occupancy.
+ */
+
+#define DEFERRED_WORK_MAX_WORKERS   4
+#define TIMER_PROBE_MAX             8
+
+typedef void (*deferred_fn_t)(void *arg, uint32_t arg2);
+
+typedef struct {
+    const char *name;           // task and metric name prefix, keep it short
+    uint32_t workers;           // 1..DEFERRED_WORK_MAX_WORKERS
+    UBaseType_t priority;
+    uint32_t stack_size;
+    uint32_t queue_length;
+    uint32_t batch_max;         // items a worker runs per wake-up
+} deferred_work_config_t;
+
+#define DEFERRED_WORK_DEFAULT_CONFIG(n) { \
+    .name = (n), .workers = 2, .priority = 4, .stack_size = 3072, \
+    .queue_length = 16, .batch_max = 8, \
+}
+
+typedef struct {
+    deferred_work_config_t config;
+    QueueHandle_t queue;
+    TaskHandle_t workers[DEFERRED_WORK_MAX_WORKERS];
+
+    lab_histogram_t *wait_us;
+    lab_histogram_t *run_us;
+    lab_histogram_t *batch;
+    lab_counter_t *submitted;
+    lab_counter_t *dropped;
+} deferred_work_t;
+
+// Creates the queue and the worker tasks; false if anything could not be created
+bool deferred_work_init(deferred_work_t *dw, const deferred_work_config_t *config);
+
+// Queues fn(arg, arg2) without blocking; false (and counted) if the queue is full
+bool deferred_work_submit(deferred_work_t *dw, deferred_fn_t fn, void *arg, uint32_t arg2);
+
+// Logs submitted/dropped, queue depth and wait/run/batch percentiles, then resets the histograms
+void deferred_work_report(deferred_work_t *dw, const char *tag);
+
+typedef struct {
+    const char *name;
+    lab_histogram_t *runtime_us;
+} timer_probe_t;
+
+// Registers the probe's <name>_cb_us histogram; false if the tables are full
+bool timer_probe_init(timer_probe_t *probe, const char *name);
+
+int64_t timer_probe_begin(void);
+void timer_probe_end(timer_probe_t *probe, int64_t start);
+
+// Logs timer service occupancy since the previous call and each probe's runtime, then resets them
+void timer_probe_report(const char *tag);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,46 @@
+#!/usr/bin/env python3
+"""Button-to-LED latency from a host_hal edge CSV.
+
+For every input edge on --input that matches --level, finds the first
+output edge on any of --outputs that follows it and reports the delay.
+
+    python3 edge_latency.py edges.csv --input 0 --level 0 --outputs 2 4
+"""
+import argparse
+import csv
+import statistics
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("csv")
+    ap.add_argument("--input", type=int, required=True, help="stimulus pin")
+    ap.add_argument("--level", type=int, default=0, help="input level that counts as a press")
+    ap.add_argument("--outputs", type=int, nargs="+", required=True, help="LED pins to watch")
+    args = ap.parse_args()
+
+    edges = []
+    with open(args.csv) as f:
+        for row in csv.DictReader(line for line in f if not line.startswith("#")):
+            edges.append((int(row["time_us"]), int(row["pin"]), int(row["level"]), row["dir"]))
+
+    latencies = []
+    for i, (t, pin, level, d) in enumerate(edges):
+        if d != "in" or pin != args.input or level != args.level:
+            continue
+        for t2, pin2, _, d2 in edges[i + 1:]:
+            if d2 == "out" and pin2 in args.outputs:
+                latencies.append(t2 - t)
+                break
+
+    if not latencies:
+        print("no matching input/output edge pairs")
+        return
+    latencies.sort()
+    p99 = latencies[min(len(latencies) - 1, int(len(latencies) * 0.99))]
+    print(f"samples={len(latencies)} min={latencies[0]}us median={statistics.median(latencies):.0f}us "
+          f"p99={p99}us max={latencies[-1]}us")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+// Host stand-in for the CCOUNT register: CLOCK_MONOTONIC nanoseconds (a 1 GHz "CPU"), wrapping at 32 bits
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void);
+
+// The POSIX port runs the scheduler on a single "core"
+static inline int esp_cpu_get_core_id(void) { return 0; }
+
+#ifdef __cplusplus
+}
+#endif
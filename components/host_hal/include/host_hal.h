@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Host HAL shim for running the labs on the ESP-IDF "linux" target
+ * (FreeRTOS POSIX port). Labs keep including driver/gpio.h, driver/gptimer.h,
+ * esp_random.h and esp_timer.h unchanged; this component provides them.
+ *
+ * Environment variables (read once, at process startup):
+ *   HOST_HAL_SCRIPT  input stimulus, "pin=level@ms[;pin=level@ms...]"
+ *                    e.g. "0=0@1000;0=1@1100" presses GPIO0 for 100 ms at t=1 s
+ *   HOST_HAL_RUN_MS  stop the run after this many ms, dump edges and exit(0)
+ *   HOST_HAL_EDGES   file to write the recorded edge CSV to (default: stdout)
+ *   HOST_HAL_SEED    seed for esp_random() so runs are reproducible
+ *
+ * All times (script, run limit, edge CSV) are esp_timer_get_time(), which starts
+ * at 0 at process startup. The stimulus task itself starts on the first
+ * gpio_config()/gptimer call; entries already due by then are applied at once.
+ */
+
+typedef enum {
+    HOST_HAL_EDGE_INPUT = 0,   // level driven by the stimulus script
+    HOST_HAL_EDGE_OUTPUT,      // level written by gpio_set_level()
+} host_hal_edge_dir_t;
+
+typedef struct {
+    int64_t time_us;
+    uint8_t pin;
+    uint8_t level;
+    uint8_t dir;               // host_hal_edge_dir_t
+} host_hal_edge_t;
+
+#define HOST_HAL_MAX_EDGES    4096
+#define HOST_HAL_MAX_STIMULI  128
+
+// Queue an input change (at_ms from process start); call before the first gpio_config()
+bool host_hal_script_input(int pin, int level, uint32_t at_ms);
+
+// Drive an input pin now (fires the pin's ISR if the edge matches intr_type)
+void host_hal_drive_input(int pin, int level);
+
+// Copy out recorded edges, returns the number copied
+size_t host_hal_get_edges(host_hal_edge_t *out, size_t max);
+uint32_t host_hal_edges_dropped(void);
+
+// Write recorded edges as CSV: time_us,pin,level,dir
+void host_hal_dump_edges(const char *path);
+
+// Internal: start the stimulus task once (the environment is parsed at startup)
+void host_hal_init_once(void);
+void host_hal_record_edge(int pin, int level, host_hal_edge_dir_t dir);
+
+#ifdef __cplusplus
+}
+#endif
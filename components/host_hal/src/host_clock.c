@@ -0,0 +1,53 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "esp_cpu.h"
+
+// Weak so a real esp_timer / esp_hw_support linux implementation wins if present
+
+static int64_t monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// The first call is made by host_hal's startup constructor, before any thread exists
+__attribute__((weak)) int64_t esp_timer_get_time(void) {
+    static int64_t start_us = 0;
+    if (start_us == 0) start_us = monotonic_us();
+    return monotonic_us() - start_us;
+}
+
+__attribute__((weak)) esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (esp_cpu_cycle_count_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+
+static uint64_t rng_state = 0;
+
+__attribute__((weak)) uint32_t esp_random(void) {
+    if (rng_state == 0) {
+        const char *seed = getenv("HOST_HAL_SEED");
+        rng_state = seed ? strtoull(seed, NULL, 0) : (uint64_t)monotonic_us();
+        if (rng_state == 0) rng_state = 0x9E3779B97F4A7C15ULL;
+    }
+    // xorshift64*: deterministic for a given HOST_HAL_SEED
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (uint32_t)((rng_state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+__attribute__((weak)) void esp_fill_random(void *buf, size_t len) {
+    uint8_t *p = (uint8_t *)buf;
+    while (len > 0) {
+        uint32_t r = esp_random();
+        size_t n = len < sizeof(r) ? len : sizeof(r);
+        memcpy(p, &r, n);
+        p += n; len -= n;
+    }
+}
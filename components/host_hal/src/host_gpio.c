@@ -0,0 +1,131 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "host_hal.h"
+
+typedef struct {
+    gpio_mode_t mode;
+    gpio_int_type_t intr_type;
+    bool intr_enabled;
+    uint8_t level;
+    gpio_isr_t isr;
+    void *isr_arg;
+} pin_state_t;
+
+static pin_state_t pins[GPIO_NUM_MAX];
+static bool isr_service_installed = false;
+static portMUX_TYPE gpio_mux = portMUX_INITIALIZER_UNLOCKED;
+
+#define PIN_VALID(n) ((n) >= 0 && (n) < GPIO_NUM_MAX)
+
+esp_err_t gpio_config(const gpio_config_t *cfg) {
+    if (!cfg) return ESP_ERR_INVALID_ARG;
+    host_hal_init_once();
+    for (int n = 0; n < GPIO_NUM_MAX; n++) {
+        if (!(cfg->pin_bit_mask & (1ULL << n))) continue;
+        pins[n].mode = cfg->mode;
+        pins[n].intr_type = cfg->intr_type;
+        pins[n].intr_enabled = cfg->intr_type != GPIO_INTR_DISABLE;
+        // Inputs idle at their pull level until the script drives them
+        if (cfg->mode & GPIO_MODE_INPUT) pins[n].level = cfg->pull_up_en ? 1 : 0;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num) {
+    if (!PIN_VALID(gpio_num)) return ESP_ERR_INVALID_ARG;
+    memset(&pins[gpio_num], 0, sizeof(pins[gpio_num]));
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode) {
+    if (!PIN_VALID(gpio_num)) return ESP_ERR_INVALID_ARG;
+    host_hal_init_once();
+    pins[gpio_num].mode = mode;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level) {
+    if (!PIN_VALID(gpio_num)) return ESP_ERR_INVALID_ARG;
+    uint8_t l = level ? 1 : 0;
+    // Only real transitions are recorded, so the CSV is an edge log
+    if (pins[gpio_num].level != l) {
+        pins[gpio_num].level = l;
+        host_hal_record_edge(gpio_num, l, HOST_HAL_EDGE_OUTPUT);
+    }
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num) {
+    return PIN_VALID(gpio_num) ? pins[gpio_num].level : 0;
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type) {
+    if (!PIN_VALID(gpio_num)) return ESP_ERR_INVALID_ARG;
+    pins[gpio_num].intr_type = intr_type;
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t gpio_num) {
+    if (!PIN_VALID(gpio_num)) return ESP_ERR_INVALID_ARG;
+    pins[gpio_num].intr_enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t gpio_num) {
+    if (!PIN_VALID(gpio_num)) return ESP_ERR_INVALID_ARG;
+    pins[gpio_num].intr_enabled = false;
+    return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags) {
+    if (isr_service_installed) return ESP_ERR_INVALID_STATE;
+    isr_service_installed = true;
+    return ESP_OK;
+}
+
+void gpio_uninstall_isr_service(void) {
+    isr_service_installed = false;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args) {
+    if (!PIN_VALID(gpio_num)) return ESP_ERR_INVALID_ARG;
+    if (!isr_service_installed) return ESP_ERR_INVALID_STATE;
+    taskENTER_CRITICAL(&gpio_mux);
+    pins[gpio_num].isr = isr_handler;
+    pins[gpio_num].isr_arg = args;
+    taskEXIT_CRITICAL(&gpio_mux);
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num) {
+    return gpio_isr_handler_add(gpio_num, NULL, NULL);
+}
+
+static bool edge_matches(gpio_int_type_t type, uint8_t old_level, uint8_t new_level) {
+    switch (type) {
+        case GPIO_INTR_POSEDGE:    return old_level == 0 && new_level == 1;
+        case GPIO_INTR_NEGEDGE:    return old_level == 1 && new_level == 0;
+        case GPIO_INTR_ANYEDGE:    return old_level != new_level;
+        case GPIO_INTR_LOW_LEVEL:  return new_level == 0;
+        case GPIO_INTR_HIGH_LEVEL: return new_level == 1;
+        default:                   return false;
+    }
+}
+
+void host_hal_drive_input(int pin, int level) {
+    if (!PIN_VALID(pin)) return;
+    uint8_t old_level = pins[pin].level;
+    uint8_t new_level = level ? 1 : 0;
+    pins[pin].level = new_level;
+    host_hal_record_edge(pin, new_level, HOST_HAL_EDGE_INPUT);
+
+    pin_state_t *p = &pins[pin];
+    if (isr_service_installed && p->isr && p->intr_enabled && edge_matches(p->intr_type, old_level, new_level)) {
+        // The stimulus task stands in for the interrupt controller: it runs at
+        // the highest priority, so FromISR APIs and portYIELD_FROM_ISR behave
+        // as they would on hardware with respect to the woken task.
+        p->isr(p->isr_arg);
+    }
+}
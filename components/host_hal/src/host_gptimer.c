@@ -0,0 +1,147 @@
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gptimer.h"
+#include "esp_timer.h"
+#include "host_hal.h"
+
+// Each gptimer is backed by a max-priority FreeRTOS task. Alarm resolution
+// is therefore one tick (1 ms with the linux target's default CONFIG_FREERTOS_HZ).
+
+struct gptimer_t {
+    uint32_t resolution_hz;
+    gptimer_count_direction_t direction;
+    gptimer_alarm_cb_t on_alarm;
+    void *user_ctx;
+    gptimer_alarm_config_t alarm;
+    bool alarm_set;
+    bool enabled;
+    bool running;
+    uint64_t base_count;        // count at the moment the timer was (re)started
+    int64_t start_us;
+    TaskHandle_t task;
+};
+
+static uint64_t current_count(gptimer_handle_t t) {
+    if (!t->running) return t->base_count;
+    uint64_t elapsed = (uint64_t)(esp_timer_get_time() - t->start_us) * t->resolution_hz / 1000000ULL;
+    return t->direction == GPTIMER_COUNT_UP ? t->base_count + elapsed : t->base_count - elapsed;
+}
+
+static void gptimer_task(void *arg) {
+    gptimer_handle_t t = (gptimer_handle_t)arg;
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (t->running && t->alarm_set) {
+            uint64_t now = current_count(t);
+            uint64_t target = t->alarm.alarm_count;
+            uint64_t remaining = t->direction == GPTIMER_COUNT_UP ? (target > now ? target - now : 0)
+                                                                  : (now > target ? now - target : 0);
+            uint64_t remaining_ms = remaining * 1000ULL / t->resolution_hz;
+            // Sleep in woken-up-early chunks so stop/disable takes effect promptly
+            if (remaining_ms > 0) {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(remaining_ms) ? pdMS_TO_TICKS(remaining_ms) : 1);
+                continue;
+            }
+            gptimer_alarm_event_data_t edata = { .count_value = now, .alarm_value = target };
+            if (t->alarm.flags.auto_reload_on_alarm) {
+                t->base_count = t->alarm.reload_count;
+                t->start_us = esp_timer_get_time();
+            } else {
+                t->alarm_set = false;
+            }
+            if (t->on_alarm && t->on_alarm(t, &edata, t->user_ctx)) {
+                portYIELD();
+            }
+        }
+    }
+}
+
+esp_err_t gptimer_new_timer(const gptimer_config_t *config, gptimer_handle_t *ret_timer) {
+    if (!config || !ret_timer || config->resolution_hz == 0) return ESP_ERR_INVALID_ARG;
+    host_hal_init_once();
+    gptimer_handle_t t = calloc(1, sizeof(struct gptimer_t));
+    if (!t) return ESP_ERR_NO_MEM;
+    t->resolution_hz = config->resolution_hz;
+    t->direction = config->direction;
+    if (xTaskCreate(gptimer_task, "HalGptimer", 4096, t, configMAX_PRIORITIES - 1, &t->task) != pdPASS) {
+        free(t);
+        return ESP_ERR_NO_MEM;
+    }
+    *ret_timer = t;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_del_timer(gptimer_handle_t timer) {
+    if (!timer) return ESP_ERR_INVALID_ARG;
+    if (timer->enabled) return ESP_ERR_INVALID_STATE;
+    vTaskDelete(timer->task);
+    free(timer);
+    return ESP_OK;
+}
+
+esp_err_t gptimer_set_raw_count(gptimer_handle_t timer, uint64_t value) {
+    if (!timer) return ESP_ERR_INVALID_ARG;
+    timer->base_count = value;
+    timer->start_us = esp_timer_get_time();
+    xTaskNotifyGive(timer->task);
+    return ESP_OK;
+}
+
+esp_err_t gptimer_get_raw_count(gptimer_handle_t timer, uint64_t *value) {
+    if (!timer || !value) return ESP_ERR_INVALID_ARG;
+    *value = current_count(timer);
+    return ESP_OK;
+}
+
+esp_err_t gptimer_register_event_callbacks(gptimer_handle_t timer, const gptimer_event_callbacks_t *cbs, void *user_data) {
+    if (!timer || !cbs) return ESP_ERR_INVALID_ARG;
+    if (timer->enabled) return ESP_ERR_INVALID_STATE;
+    timer->on_alarm = cbs->on_alarm;
+    timer->user_ctx = user_data;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_set_alarm_action(gptimer_handle_t timer, const gptimer_alarm_config_t *config) {
+    if (!timer) return ESP_ERR_INVALID_ARG;
+    if (config) {
+        timer->alarm = *config;
+        timer->alarm_set = true;
+    } else {
+        timer->alarm_set = false;
+    }
+    xTaskNotifyGive(timer->task);
+    return ESP_OK;
+}
+
+esp_err_t gptimer_enable(gptimer_handle_t timer) {
+    if (!timer) return ESP_ERR_INVALID_ARG;
+    if (timer->enabled) return ESP_ERR_INVALID_STATE;
+    timer->enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_disable(gptimer_handle_t timer) {
+    if (!timer) return ESP_ERR_INVALID_ARG;
+    if (!timer->enabled || timer->running) return ESP_ERR_INVALID_STATE;
+    timer->enabled = false;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_start(gptimer_handle_t timer) {
+    if (!timer) return ESP_ERR_INVALID_ARG;
+    if (!timer->enabled || timer->running) return ESP_ERR_INVALID_STATE;
+    timer->start_us = esp_timer_get_time();
+    timer->running = true;
+    xTaskNotifyGive(timer->task);
+    return ESP_OK;
+}
+
+esp_err_t gptimer_stop(gptimer_handle_t timer) {
+    if (!timer) return ESP_ERR_INVALID_ARG;
+    if (!timer->running) return ESP_ERR_INVALID_STATE;
+    timer->base_count = current_count(timer);
+    timer->running = false;
+    xTaskNotifyGive(timer->task);
+    return ESP_OK;
+}
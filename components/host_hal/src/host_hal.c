@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "host_hal.h"
+
+static const char *TAG = "HOST_HAL";
+
+typedef struct { uint32_t at_ms; uint8_t pin; uint8_t level; } stimulus_t;
+
+static stimulus_t stimuli[HOST_HAL_MAX_STIMULI];
+static size_t stimulus_count = 0;
+
+static host_hal_edge_t edges[HOST_HAL_MAX_EDGES];
+static size_t edge_count = 0;
+static uint32_t edges_dropped = 0;
+static portMUX_TYPE edge_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+static atomic_bool stimulus_started = false;
+static uint32_t run_ms = 0;
+
+void host_hal_record_edge(int pin, int level, host_hal_edge_dir_t dir) {
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&edge_mux);
+    if (edge_count < HOST_HAL_MAX_EDGES) {
+        edges[edge_count++] = (host_hal_edge_t){ .time_us = now, .pin = (uint8_t)pin, .level = (uint8_t)level, .dir = (uint8_t)dir };
+    } else {
+        edges_dropped++;
+    }
+    taskEXIT_CRITICAL(&edge_mux);
+}
+
+size_t host_hal_get_edges(host_hal_edge_t *out, size_t max) {
+    taskENTER_CRITICAL(&edge_mux);
+    size_t n = edge_count < max ? edge_count : max;
+    memcpy(out, edges, n * sizeof(host_hal_edge_t));
+    taskEXIT_CRITICAL(&edge_mux);
+    return n;
+}
+
+uint32_t host_hal_edges_dropped(void) {
+    return edges_dropped;
+}
+
+void host_hal_dump_edges(const char *path) {
+    FILE *f = path ? fopen(path, "w") : stdout;
+    if (!f) {
+        ESP_LOGE(TAG, "Cannot open %s for edge dump", path);
+        f = stdout;
+    }
+    fprintf(f, "time_us,pin,level,dir\n");
+    for (size_t i = 0; i < edge_count; i++) {
+        fprintf(f, "%lld,%u,%u,%s\n", (long long)edges[i].time_us, edges[i].pin, edges[i].level,
+                edges[i].dir == HOST_HAL_EDGE_INPUT ? "in" : "out");
+    }
+    if (edges_dropped) fprintf(f, "# dropped %lu edges (buffer full)\n", (unsigned long)edges_dropped);
+    if (f != stdout) fclose(f);
+}
+
+bool host_hal_script_input(int pin, int level, uint32_t at_ms) {
+    if (stimulus_count >= HOST_HAL_MAX_STIMULI || pin < 0 || pin > 255) return false;
+    // Keep the script sorted by time (insertion sort, scripts are short)
+    size_t i = stimulus_count++;
+    while (i > 0 && stimuli[i - 1].at_ms > at_ms) { stimuli[i] = stimuli[i - 1]; i--; }
+    stimuli[i] = (stimulus_t){ .at_ms = at_ms, .pin = (uint8_t)pin, .level = (uint8_t)(level != 0) };
+    return true;
+}
+
+// Runs before main(): reports on stderr, not through esp_log
+static void parse_script(const char *script) {
+    // "pin=level@ms;pin=level@ms..."
+    const char *p = script;
+    while (*p) {
+        int pin, level; unsigned long at_ms; int consumed = 0;
+        if (sscanf(p, " %d = %d @ %lu%n", &pin, &level, &at_ms, &consumed) != 3) {
+            fprintf(stderr, "HOST_HAL: bad HOST_HAL_SCRIPT entry near \"%s\"\n", p);
+            return;
+        }
+        if (!host_hal_script_input(pin, level, (uint32_t)at_ms)) {
+            fprintf(stderr, "HOST_HAL: stimulus table full, ignoring rest of script\n");
+            return;
+        }
+        p += consumed;
+        while (*p == ';' || *p == ',' || *p == ' ') p++;
+    }
+}
+
+// Script times are measured on the esp_timer time base, which starts at process startup
+static void stimulus_task(void *pvParameters) {
+    for (size_t i = 0; i < stimulus_count; i++) {
+        int64_t wait_us = (int64_t)stimuli[i].at_ms * 1000 - esp_timer_get_time();
+        if (wait_us > 0) vTaskDelay(pdMS_TO_TICKS((wait_us + 999) / 1000));
+        host_hal_drive_input(stimuli[i].pin, stimuli[i].level);
+    }
+    vTaskDelete(NULL);
+}
+
+// A plain thread rather than a task: the limit must hold even if app_main never yields
+static void *run_limit_thread(void *arg) {
+    int64_t wait_us = (int64_t)run_ms * 1000 - esp_timer_get_time();
+    if (wait_us > 0) {
+        struct timespec ts = { .tv_sec = wait_us / 1000000, .tv_nsec = (wait_us % 1000000) * 1000 };
+        while (nanosleep(&ts, &ts) != 0) {
+        }
+    }
+    printf("HOST_HAL: run time of %lu ms reached, dumping edges\n", (unsigned long)run_ms);
+    host_hal_dump_edges(getenv("HOST_HAL_EDGES"));
+    fflush(stdout);
+    exit(0);
+}
+
+static void host_hal_init(void) {
+    esp_timer_get_time();   // pins the time base to process startup
+    const char *script = getenv("HOST_HAL_SCRIPT");
+    if (script) parse_script(script);
+    const char *run = getenv("HOST_HAL_RUN_MS");
+    if (run) run_ms = (uint32_t)strtoul(run, NULL, 10);
+    if (run_ms > 0) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, run_limit_thread, NULL) == 0) {
+            pthread_detach(thread);
+        } else {
+            fprintf(stderr, "HOST_HAL: cannot start the HOST_HAL_RUN_MS timer\n");
+        }
+    }
+}
+
+// Runs before main(), so HOST_HAL_RUN_MS and script times count from process start
+__attribute__((constructor)) static void host_hal_startup(void) {
+    pthread_once(&init_once, host_hal_init);
+}
+
+void host_hal_init_once(void) {
+    pthread_once(&init_once, host_hal_init);
+    if (stimulus_count == 0 || atomic_exchange(&stimulus_started, true)) return;
+    ESP_LOGI(TAG, "Host HAL: %u stimuli, run limit %lu ms", (unsigned)stimulus_count, (unsigned long)run_ms);
+    // Highest priority so stimuli land on time regardless of lab load
+    xTaskCreate(stimulus_task, "HalStimulus", 4096, NULL, configMAX_PRIORITIES - 1, NULL);
+}
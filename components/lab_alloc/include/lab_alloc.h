@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Compile-time tables for a lab's tasks and kernel objects.
+ *
+ * A lab lists what it needs once, at file scope:
+ *
+ *   static const lab_object_def_t objects[] = {
+ *       LAB_QUEUE(&xQueue, 5, sizeof(msg_t)),
+ *       LAB_MUTEX(&xMutex),
+ *   };
+ *   static const lab_task_def_t tasks[] = {
+ *       LAB_TASK(sender_task, "Sender", 2048, NULL, 2, NULL),
+ *   };
+ *
+ * and creates them with lab_objects_create()/lab_tasks_create().
+ *
+ * With LAB_STATIC_ALLOCATION=1 (idf.py -DLAB_STATIC_ALLOCATION=1 build, or a
+ * #define before this header) each entry also reserves its stack, TCB, queue
+ * storage and control block in .bss through file-scope compound literals, and
+ * everything is created with the *Static APIs: RAM use is fixed at link time
+ * and nothing comes from the heap. Otherwise the same tables use the regular
+ * heap-allocating calls, so the two modes can be compared directly with
+ * lab_alloc_report().
+ *
+ * Queue sets have no static variant in this kernel and stay dynamic.
+ */
+
+#ifndef LAB_STATIC_ALLOCATION
+#define LAB_STATIC_ALLOCATION 0
+#endif
+
+typedef struct {
+    TaskFunction_t function;
+    const char *name;
+    uint32_t stack_depth;          // same unit as xTaskCreate()
+    void *arg;
+    UBaseType_t priority;
+    TaskHandle_t *handle;          // optional; static tasks get it only after creation returns
+    StackType_t *stack;            // static mode only
+    StaticTask_t *tcb;
+} lab_task_def_t;
+
+typedef enum {
+    LAB_OBJ_QUEUE,
+    LAB_OBJ_BINARY_SEMAPHORE,
+    LAB_OBJ_COUNTING_SEMAPHORE,
+    LAB_OBJ_MUTEX,
+} lab_object_kind_t;
+
+typedef struct {
+    lab_object_kind_t kind;
+    QueueHandle_t *handle;         // SemaphoreHandle_t is a QueueHandle_t
+    UBaseType_t length;            // queue length / counting max
+    UBaseType_t item_size;         // queue item size / counting initial count
+    uint8_t *storage;              // static queue storage
+    StaticQueue_t *control;        // static mode only
+} lab_object_def_t;
+
+#if LAB_STATIC_ALLOCATION
+// File-scope compound literals have static storage duration, i.e. they land in .bss
+#define LAB_STATIC_STACK(depth)    ((StackType_t[(depth)]){ 0 })
+#define LAB_STATIC_TCB()           (&(StaticTask_t){ 0 })
+#define LAB_STATIC_BYTES(n)        ((uint8_t[(n) ? (n) : 1]){ 0 })
+#define LAB_STATIC_QCB()           (&(StaticQueue_t){ 0 })
+#else
+#define LAB_STATIC_STACK(depth)    NULL
+#define LAB_STATIC_TCB()           NULL
+#define LAB_STATIC_BYTES(n)        NULL
+#define LAB_STATIC_QCB()           NULL
+#endif
+
+#define LAB_TASK(fn, name, depth, arg, priority, handle) \
+    { (fn), (name), (depth), (void *)(arg), (priority), (handle), LAB_STATIC_STACK(depth), LAB_STATIC_TCB() }
+
+#define LAB_QUEUE(handle, length, item_size) \
+    { LAB_OBJ_QUEUE, (handle), (length), (item_size), LAB_STATIC_BYTES((length) * (item_size)), LAB_STATIC_QCB() }
+#define LAB_BINARY_SEMAPHORE(handle) \
+    { LAB_OBJ_BINARY_SEMAPHORE, (handle), 1, 0, NULL, LAB_STATIC_QCB() }
+#define LAB_COUNTING_SEMAPHORE(handle, max, initial) \
+    { LAB_OBJ_COUNTING_SEMAPHORE, (handle), (max), (initial), NULL, LAB_STATIC_QCB() }
+#define LAB_MUTEX(handle) \
+    { LAB_OBJ_MUTEX, (handle), 1, 0, NULL, LAB_STATIC_QCB() }
+
+#define LAB_ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+// Create every entry in order; false (after logging which one) if any creation failed
+bool lab_objects_create(const lab_object_def_t *defs, size_t count);
+bool lab_tasks_create(const lab_task_def_t *defs, size_t count);
+
+// Logs the allocation mode, time since boot, time spent creating, bytes reserved
+// statically and the current / minimum free heap
+void lab_alloc_report(const char *tag);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "lab_alloc.h"
+
+static const char *TAG = "LAB_ALLOC";
+
+// Accumulated over all tables a lab creates
+static struct {
+    uint32_t static_bytes;
+    uint32_t static_entries;
+    uint32_t dynamic_entries;
+    int64_t create_us;
+} totals;
+
+// Entries carry their own buffers when the table was built with LAB_STATIC_ALLOCATION,
+// so the choice is made per entry rather than by how this file was compiled
+static QueueHandle_t create_object(const lab_object_def_t *d) {
+    if (d->control) {
+        totals.static_bytes += sizeof(StaticQueue_t);
+        switch (d->kind) {
+            case LAB_OBJ_QUEUE:
+                totals.static_bytes += d->length * d->item_size;
+                return xQueueCreateStatic(d->length, d->item_size, d->storage, d->control);
+            case LAB_OBJ_BINARY_SEMAPHORE: return xSemaphoreCreateBinaryStatic(d->control);
+            case LAB_OBJ_COUNTING_SEMAPHORE: return xSemaphoreCreateCountingStatic(d->length, d->item_size, d->control);
+            case LAB_OBJ_MUTEX: return xSemaphoreCreateMutexStatic(d->control);
+        }
+        return NULL;
+    }
+    switch (d->kind) {
+        case LAB_OBJ_QUEUE: return xQueueCreate(d->length, d->item_size);
+        case LAB_OBJ_BINARY_SEMAPHORE: return xSemaphoreCreateBinary();
+        case LAB_OBJ_COUNTING_SEMAPHORE: return xSemaphoreCreateCounting(d->length, d->item_size);
+        case LAB_OBJ_MUTEX: return xSemaphoreCreateMutex();
+    }
+    return NULL;
+}
+
+bool lab_objects_create(const lab_object_def_t *defs, size_t count) {
+    int64_t start_us = esp_timer_get_time();
+    bool ok = true;
+    for (size_t i = 0; i < count; i++) {
+        const lab_object_def_t *d = &defs[i];
+        QueueHandle_t h = create_object(d);
+        if (d->handle) *d->handle = h;
+        if (d->control) totals.static_entries++;
+        else totals.dynamic_entries++;
+        if (!h) {
+            ESP_LOGE(TAG, "Failed to create kernel object #%u (kind %d)", (unsigned)i, (int)d->kind);
+            ok = false;
+        }
+    }
+    totals.create_us += esp_timer_get_time() - start_us;
+    return ok;
+}
+
+bool lab_tasks_create(const lab_task_def_t *defs, size_t count) {
+    int64_t start_us = esp_timer_get_time();
+    bool ok = true;
+    for (size_t i = 0; i < count; i++) {
+        const lab_task_def_t *d = &defs[i];
+        TaskHandle_t h = NULL;
+        if (d->stack && d->tcb) {
+            h = xTaskCreateStatic(d->function, d->name, d->stack_depth, d->arg, d->priority, d->stack, d->tcb);
+            if (d->handle) *d->handle = h;
+            totals.static_bytes += d->stack_depth * sizeof(StackType_t) + sizeof(StaticTask_t);
+            totals.static_entries++;
+        } else {
+            // Let the kernel store the handle so it is valid before the new task first runs
+            TaskHandle_t *out = d->handle ? d->handle : &h;
+            if (xTaskCreate(d->function, d->name, d->stack_depth, d->arg, d->priority, out) != pdPASS) *out = NULL;
+            h = *out;
+            totals.dynamic_entries++;
+        }
+        if (!h) {
+            ESP_LOGE(TAG, "Failed to create task %s", d->name);
+            ok = false;
+        }
+    }
+    totals.create_us += esp_timer_get_time() - start_us;
+    return ok;
+}
+
+void lab_alloc_report(const char *tag) {
+    const char *mode = totals.dynamic_entries == 0 ? "static" : totals.static_entries == 0 ? "dynamic" : "mixed";
+    ESP_LOGI(tag, "📦 Allocation: %s | %lu static / %lu heap objects | %lu B reserved in .bss",
+             mode, (unsigned long)totals.static_entries, (unsigned long)totals.dynamic_entries,
+             (unsigned long)totals.static_bytes);
+    ESP_LOGI(tag, "📦 Ready %lld us after boot (creation %lld us) | free heap %lu B, minimum %lu B",
+             esp_timer_get_time(), totals.create_us, (unsigned long)esp_get_free_heap_size(),
+             (unsigned long)esp_get_minimum_free_heap_size());
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Small metrics registry for the labs: named counters, gauges and histograms.
+ *
+ * Registration (lab_counter()/lab_gauge()/lab_histogram()) is done once at
+ * start-up and takes a critical section. Everything on the hot path is a
+ * single relaxed atomic operation, so tasks on either core can update a
+ * metric concurrently without locks and without losing counts.
+ *
+ * Counters keep one shard per core and are summed only when read.
+ * Histograms are log-linear (HDR style): each power-of-two range is split
+ * into LAB_HIST_SUB_BUCKETS linear buckets, giving ~1/LAB_HIST_SUB_BUCKETS
+ * relative error over the full uint32_t range.
+ */
+
+#define LAB_METRICS_MAX_COUNTERS    24
+#define LAB_METRICS_MAX_GAUGES      8
+#define LAB_METRICS_MAX_HISTOGRAMS  16
+#define LAB_METRICS_NAME_LEN        24
+
+#ifdef portNUM_PROCESSORS
+#define LAB_METRICS_SHARDS portNUM_PROCESSORS
+#else
+#define LAB_METRICS_SHARDS 1
+#endif
+
+#define LAB_HIST_SUB_BITS     3
+#define LAB_HIST_SUB_BUCKETS  (1 << LAB_HIST_SUB_BITS)
+#define LAB_HIST_BUCKETS      ((32 - LAB_HIST_SUB_BITS + 1) * LAB_HIST_SUB_BUCKETS)
+
+typedef struct {
+    char name[LAB_METRICS_NAME_LEN];
+    _Atomic uint32_t shard[LAB_METRICS_SHARDS];
+} lab_counter_t;
+
+typedef struct {
+    char name[LAB_METRICS_NAME_LEN];
+    _Atomic int32_t value;
+} lab_gauge_t;
+
+typedef struct {
+    char name[LAB_METRICS_NAME_LEN];
+    _Atomic uint32_t buckets[LAB_HIST_BUCKETS];
+    _Atomic uint32_t count;
+    _Atomic uint32_t max;
+} lab_histogram_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t mean;
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t max;
+} lab_hist_summary_t;
+
+// Look up a metric by name, creating it on first use. NULL when the table is full.
+lab_counter_t *lab_counter(const char *name);
+lab_gauge_t *lab_gauge(const char *name);
+lab_histogram_t *lab_histogram(const char *name);
+
+static inline uint32_t lab_metrics_shard(void) {
+#if LAB_METRICS_SHARDS > 1
+    return (uint32_t)xPortGetCoreID();
+#else
+    return 0;
+#endif
+}
+
+static inline void lab_counter_add(lab_counter_t *c, uint32_t n) {
+    atomic_fetch_add_explicit(&c->shard[lab_metrics_shard()], n, memory_order_relaxed);
+}
+
+static inline void lab_counter_inc(lab_counter_t *c) {
+    lab_counter_add(c, 1);
+}
+
+uint32_t lab_counter_read(lab_counter_t *c);
+
+static inline void lab_gauge_set(lab_gauge_t *g, int32_t v) {
+    atomic_store_explicit(&g->value, v, memory_order_relaxed);
+}
+
+static inline void lab_gauge_add(lab_gauge_t *g, int32_t delta) {
+    atomic_fetch_add_explicit(&g->value, delta, memory_order_relaxed);
+}
+
+static inline int32_t lab_gauge_read(lab_gauge_t *g) {
+    return atomic_load_explicit(&g->value, memory_order_relaxed);
+}
+
+void lab_hist_record(lab_histogram_t *h, uint32_t value);
+
+// Summary of everything recorded so far; percentiles are bucket upper bounds
+void lab_hist_summary(lab_histogram_t *h, lab_hist_summary_t *out);
+uint32_t lab_hist_percentile(lab_histogram_t *h, float percentile);
+
+// Inclusive upper bound of bucket index, for exporting raw buckets
+uint32_t lab_hist_bucket_upper(uint32_t index);
+
+// Clears a histogram for the next reporting window (records racing with it may be lost)
+void lab_hist_reset(lab_histogram_t *h);
+
+// Print every registered metric
+void lab_metrics_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lab_metrics.h"
+
+static lab_counter_t counters[LAB_METRICS_MAX_COUNTERS];
+static lab_gauge_t gauges[LAB_METRICS_MAX_GAUGES];
+// Histograms are ~1 KB each, so they come from the heap only when a lab registers one
+static lab_histogram_t *histograms[LAB_METRICS_MAX_HISTOGRAMS];
+static int counter_count = 0, gauge_count = 0, histogram_count = 0;
+static portMUX_TYPE registry_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Registration is rare, so a linear search under the registry lock is fine
+#define REGISTER(table, count, max, name)                                   \
+    do {                                                                    \
+        void *found = NULL;                                                 \
+        taskENTER_CRITICAL(&registry_mux);                                  \
+        for (int i = 0; i < (count); i++) {                                 \
+            if (strncmp((table)[i].name, (name), LAB_METRICS_NAME_LEN) == 0) { \
+                found = &(table)[i];                                        \
+                break;                                                      \
+            }                                                               \
+        }                                                                   \
+        if (!found && (count) < (max)) {                                    \
+            strncpy((table)[count].name, (name), LAB_METRICS_NAME_LEN - 1); \
+            found = &(table)[(count)++];                                    \
+        }                                                                   \
+        taskEXIT_CRITICAL(&registry_mux);                                   \
+        return found;                                                       \
+    } while (0)
+
+lab_counter_t *lab_counter(const char *name) {
+    REGISTER(counters, counter_count, LAB_METRICS_MAX_COUNTERS, name);
+}
+
+lab_gauge_t *lab_gauge(const char *name) {
+    REGISTER(gauges, gauge_count, LAB_METRICS_MAX_GAUGES, name);
+}
+
+lab_histogram_t *lab_histogram(const char *name) {
+    // Allocate outside the critical section; dropped again if the name already exists
+    lab_histogram_t *fresh = calloc(1, sizeof(lab_histogram_t));
+    lab_histogram_t *found = NULL;
+    if (fresh) strncpy(fresh->name, name, LAB_METRICS_NAME_LEN - 1);
+    taskENTER_CRITICAL(&registry_mux);
+    for (int i = 0; i < histogram_count; i++) {
+        if (strncmp(histograms[i]->name, name, LAB_METRICS_NAME_LEN) == 0) {
+            found = histograms[i];
+            break;
+        }
+    }
+    if (!found && fresh && histogram_count < LAB_METRICS_MAX_HISTOGRAMS) {
+        found = histograms[histogram_count++] = fresh;
+        fresh = NULL;
+    }
+    taskEXIT_CRITICAL(&registry_mux);
+    free(fresh);
+    return found;
+}
+
+uint32_t lab_counter_read(lab_counter_t *c) {
+    uint32_t total = 0;
+    for (int i = 0; i < LAB_METRICS_SHARDS; i++) {
+        total += atomic_load_explicit(&c->shard[i], memory_order_relaxed);
+    }
+    return total;
+}
+
+// Values below LAB_HIST_SUB_BUCKETS get exact buckets; above that, the top
+// LAB_HIST_SUB_BITS bits after the leading one select a linear sub-bucket.
+static uint32_t bucket_index(uint32_t value) {
+    if (value < LAB_HIST_SUB_BUCKETS) return value;
+    uint32_t msb = 31 - (uint32_t)__builtin_clz(value);
+    uint32_t shift = msb - LAB_HIST_SUB_BITS;
+    uint32_t sub = (value >> shift) & (LAB_HIST_SUB_BUCKETS - 1);
+    return (shift + 1) * LAB_HIST_SUB_BUCKETS + sub;
+}
+
+static uint32_t bucket_lower(uint32_t index) {
+    if (index < LAB_HIST_SUB_BUCKETS) return index;
+    uint32_t shift = index / LAB_HIST_SUB_BUCKETS - 1;
+    uint32_t sub = index % LAB_HIST_SUB_BUCKETS;
+    return (LAB_HIST_SUB_BUCKETS + sub) << shift;
+}
+
+static uint32_t bucket_upper(uint32_t index) {
+    if (index + 1 >= LAB_HIST_BUCKETS) return UINT32_MAX;
+    return bucket_lower(index + 1) - 1;
+}
+
+uint32_t lab_hist_bucket_upper(uint32_t index) {
+    return bucket_upper(index);
+}
+
+void lab_hist_record(lab_histogram_t *h, uint32_t value) {
+    atomic_fetch_add_explicit(&h->buckets[bucket_index(value)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->count, 1, memory_order_relaxed);
+    uint32_t seen = atomic_load_explicit(&h->max, memory_order_relaxed);
+    while (value > seen &&
+           !atomic_compare_exchange_weak_explicit(&h->max, &seen, value, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+uint32_t lab_hist_percentile(lab_histogram_t *h, float percentile) {
+    uint32_t total = 0;
+    for (int i = 0; i < LAB_HIST_BUCKETS; i++) total += atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+    if (total == 0) return 0;
+    uint32_t rank = (uint32_t)(percentile / 100.0f * total + 0.5f);
+    if (rank == 0) rank = 1;
+    uint32_t seen = 0;
+    uint32_t max = atomic_load_explicit(&h->max, memory_order_relaxed);
+    for (int i = 0; i < LAB_HIST_BUCKETS; i++) {
+        seen += atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+        if (seen >= rank) {
+            uint32_t upper = bucket_upper(i);
+            return upper < max ? upper : max;
+        }
+    }
+    return max;
+}
+
+void lab_hist_summary(lab_histogram_t *h, lab_hist_summary_t *out) {
+    uint32_t snapshot[LAB_HIST_BUCKETS];
+    uint32_t total = 0;
+    uint64_t weighted = 0;
+    memset(out, 0, sizeof(*out));
+    for (int i = 0; i < LAB_HIST_BUCKETS; i++) {
+        snapshot[i] = atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+        total += snapshot[i];
+        // Bucket midpoint as the representative value for the mean
+        weighted += (uint64_t)snapshot[i] * ((bucket_lower(i) + (uint64_t)bucket_upper(i)) / 2);
+    }
+    if (total == 0) return;
+    out->count = total;
+    out->max = atomic_load_explicit(&h->max, memory_order_relaxed);
+    out->mean = (uint32_t)(weighted / total);
+
+    const float targets[] = { 50.0f, 90.0f, 99.0f };
+    uint32_t *results[] = { &out->p50, &out->p90, &out->p99 };
+    int next = 0;
+    uint32_t seen = 0;
+    bool min_found = false;
+    for (int i = 0; i < LAB_HIST_BUCKETS && next < 3; i++) {
+        if (snapshot[i] == 0) continue;
+        if (!min_found) { out->min = bucket_lower(i); min_found = true; }
+        seen += snapshot[i];
+        while (next < 3 && seen >= (uint32_t)(targets[next] / 100.0f * total + 0.5f)) {
+            uint32_t upper = bucket_upper(i);
+            *results[next++] = upper < out->max ? upper : out->max;
+        }
+    }
+}
+
+void lab_hist_reset(lab_histogram_t *h) {
+    for (int i = 0; i < LAB_HIST_BUCKETS; i++) atomic_store_explicit(&h->buckets[i], 0, memory_order_relaxed);
+    atomic_store_explicit(&h->count, 0, memory_order_relaxed);
+    atomic_store_explicit(&h->max, 0, memory_order_relaxed);
+}
+
+void lab_metrics_dump(void) {
+    for (int i = 0; i < counter_count; i++) {
+        printf("  counter   %-20s %lu\n", counters[i].name, (unsigned long)lab_counter_read(&counters[i]));
+    }
+    for (int i = 0; i < gauge_count; i++) {
+        printf("  gauge     %-20s %ld\n", gauges[i].name, (long)lab_gauge_read(&gauges[i]));
+    }
+    for (int i = 0; i < histogram_count; i++) {
+        lab_hist_summary_t s;
+        lab_hist_summary(histograms[i], &s);
+        printf("  histogram %-20s n=%lu p50=%lu p90=%lu p99=%lu max=%lu\n", histograms[i]->name,
+               (unsigned long)s.count, (unsigned long)s.p50, (unsigned long)s.p90,
+               (unsigned long)s.p99, (unsigned long)s.max);
+    }
+}
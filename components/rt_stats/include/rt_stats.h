@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Allocation-free runtime statistics snapshots.
+ *
+ * rt_stats_sample() copies the task table with uxTaskGetSystemState() into the
+ * caller's preallocated rt_stats_t and computes each task's run-time counter
+ * delta since the previous sample. Nothing is formatted and nothing is
+ * allocated, so sampling is cheap enough to run every few hundred ms;
+ * rt_stats_print() formats only when asked.
+ *
+ * CPU% is per interval and relative to the capacity of all cores
+ * (interval * portNUM_PROCESSORS), so the rows add up to ~100% including IDLE.
+ *
+ * Needs configUSE_TRACE_FACILITY and configGENERATE_RUN_TIME_STATS
+ * (CONFIG_FREERTOS_USE_TRACE_FACILITY / CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS);
+ * without them rt_stats_sample() returns 0.
+ */
+
+#define RT_STATS_MAX_TASKS 24
+
+#ifdef configRUN_TIME_COUNTER_TYPE
+typedef configRUN_TIME_COUNTER_TYPE rt_stats_counter_t;
+#else
+typedef uint32_t rt_stats_counter_t;
+#endif
+
+typedef struct {
+    UBaseType_t task_number;
+    rt_stats_counter_t run_time;
+} rt_stats_prev_t;
+
+typedef struct {
+    TaskStatus_t status[RT_STATS_MAX_TASKS];        // latest snapshot
+    rt_stats_counter_t delta[RT_STATS_MAX_TASKS];   // run time in the last interval, per status[] row
+    UBaseType_t count;
+    rt_stats_counter_t total_delta;                 // wall-clock run-time ticks in the last interval
+    rt_stats_counter_t total;
+    UBaseType_t dropped;                            // tasks that did not fit in status[]
+
+    rt_stats_prev_t prev[RT_STATS_MAX_TASKS];
+    UBaseType_t prev_count;
+} rt_stats_t;
+
+void rt_stats_init(rt_stats_t *stats);
+
+// Takes a new snapshot; returns the number of tasks captured (0 if unsupported)
+UBaseType_t rt_stats_sample(rt_stats_t *stats);
+
+// CPU share of status[i] in the last interval, in tenths of a percent
+uint32_t rt_stats_cpu_permille(const rt_stats_t *stats, UBaseType_t i);
+
+// Logs one line per task: name, state, priority, stack high-water mark and interval CPU%
+void rt_stats_print(const rt_stats_t *stats, const char *tag);
+
+const char *rt_stats_state_name(eTaskState state);
+
+#ifdef __cplusplus
+}
+#endif
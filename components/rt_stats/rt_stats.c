@@ -0,0 +1,82 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "rt_stats.h"
+
+#if !defined(portNUM_PROCESSORS)
+#define portNUM_PROCESSORS 1
+#endif
+
+void rt_stats_init(rt_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+// Tasks are matched across samples by xTaskNumber, which is never reused
+// A task created during the interval has run for all of its counter
+static rt_stats_counter_t previous_run_time(const rt_stats_t *stats, UBaseType_t task_number) {
+    for (UBaseType_t i = 0; i < stats->prev_count; i++) {
+        if (stats->prev[i].task_number == task_number) return stats->prev[i].run_time;
+    }
+    return 0;
+}
+
+UBaseType_t rt_stats_sample(rt_stats_t *stats) {
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+    rt_stats_counter_t total = 0;
+    UBaseType_t running = uxTaskGetNumberOfTasks();
+    UBaseType_t count = uxTaskGetSystemState(stats->status, RT_STATS_MAX_TASKS, &total);
+    // uxTaskGetSystemState() returns 0 when the array is too small; keep the previous baseline
+    stats->dropped = count ? 0 : running;
+    stats->count = count;
+    if (count == 0) return 0;
+    stats->total_delta = total - stats->total;   // unsigned: survives counter wrap
+    stats->total = total;
+
+    for (UBaseType_t i = 0; i < count; i++) {
+        stats->delta[i] = stats->status[i].ulRunTimeCounter - previous_run_time(stats, stats->status[i].xTaskNumber);
+    }
+    for (UBaseType_t i = 0; i < count; i++) {
+        stats->prev[i].task_number = stats->status[i].xTaskNumber;
+        stats->prev[i].run_time = stats->status[i].ulRunTimeCounter;
+    }
+    stats->prev_count = count;
+    return count;
+#else
+    (void)stats;
+    return 0;
+#endif
+}
+
+uint32_t rt_stats_cpu_permille(const rt_stats_t *stats, UBaseType_t i) {
+    uint64_t capacity = (uint64_t)stats->total_delta * portNUM_PROCESSORS;
+    if (i >= stats->count || capacity == 0) return 0;
+    return (uint32_t)(((uint64_t)stats->delta[i] * 1000 + capacity / 2) / capacity);
+}
+
+const char *rt_stats_state_name(eTaskState state) {
+    switch (state) {
+        case eRunning: return "Running";
+        case eReady: return "Ready";
+        case eBlocked: return "Blocked";
+        case eSuspended: return "Suspended";
+        case eDeleted: return "Deleted";
+        default: return "?";
+    }
+}
+
+void rt_stats_print(const rt_stats_t *stats, const char *tag) {
+    if (stats->count == 0) {
+        ESP_LOGW(tag, "No runtime stats (enable CONFIG_FREERTOS_USE_TRACE_FACILITY and CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS%s)",
+                 stats->dropped ? ", or raise RT_STATS_MAX_TASKS" : "");
+        return;
+    }
+    ESP_LOGI(tag, "%-16s %-9s %4s %6s %7s", "Task", "State", "Prio", "Stack", "CPU%");
+    for (UBaseType_t i = 0; i < stats->count; i++) {
+        const TaskStatus_t *t = &stats->status[i];
+        uint32_t permille = rt_stats_cpu_permille(stats, i);
+        ESP_LOGI(tag, "%-16s %-9s %4u %6lu %4lu.%lu%%", t->pcTaskName, rt_stats_state_name(t->eCurrentState),
+                 (unsigned)t->uxCurrentPriority, (unsigned long)t->usStackHighWaterMark,
+                 (unsigned long)(permille / 10), (unsigned long)(permille % 10));
+    }
+}
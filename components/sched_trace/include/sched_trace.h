@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sched_trace_hooks.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Binary scheduler trace recorder.
+ *
+ * The kernel's trace macros (sched_trace_hooks.h) write 12-byte events into a
+ * fixed ring in .bss: task switch in/out, task create/delete, queue send/receive,
+ * semaphore give/take, blocking on either, and ISR enter/exit. Recording is a
+ * flag test, one atomic increment, a timestamp read and three stores, with no
+ * locks and no allocation, so it can stay enabled in normal builds. When the
+ * ring is full the oldest events are overwritten (flight-recorder style).
+ *
+ * sched_trace_dump() prints the ring as hex lines between "#SCHED_TRACE" markers;
+ * sched_trace_decode.py turns a captured monitor log into Chrome/Perfetto JSON.
+ */
+
+#ifndef SCHED_TRACE_EVENTS
+#define SCHED_TRACE_EVENTS 1024        // power of two; 12 B each
+#endif
+#ifndef SCHED_TRACE_MAX_NAMES
+#define SCHED_TRACE_MAX_NAMES 32       // task and object names kept for the decoder
+#endif
+
+typedef struct __attribute__((packed)) {
+    uint32_t timestamp_us;             // esp_timer time, wraps every ~71 min
+    uint32_t obj;                      // task or queue handle
+    uint8_t type;                      // sched_trace_event_t
+    uint8_t core;
+    uint16_t arg;
+} sched_trace_entry_t;
+
+// Calibrates the per-event cost and starts recording
+void sched_trace_start(void);
+void sched_trace_stop(void);
+bool sched_trace_running(void);
+
+// Names a queue/semaphore/mutex for the timeline (tasks are named automatically)
+void sched_trace_name(const void *obj, const char *name);
+
+// User markers and manual ISR slices for ISRs the port does not report
+static inline void sched_trace_mark(uint16_t value) { sched_trace_record(SCHED_EV_MARK, 0, value); }
+static inline void sched_trace_isr_enter(uint16_t id) { sched_trace_record(SCHED_EV_ISR_ENTER, 0, id); }
+static inline void sched_trace_isr_exit(void) { sched_trace_record(SCHED_EV_ISR_EXIT, 0, 0); }
+
+// Pauses recording, prints names and events for sched_trace_decode.py, then resumes
+void sched_trace_dump(void);
+
+// Dump command: call periodically from a task; typing 'd' in the monitor dumps the trace
+void sched_trace_poll_console(void);
+
+// Events recorded since start, and how many of those were overwritten before a dump
+uint32_t sched_trace_recorded(void);
+uint32_t sched_trace_overwritten(void);
+
+// Measured cost of one event, in nanoseconds (valid after sched_trace_start())
+uint32_t sched_trace_event_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
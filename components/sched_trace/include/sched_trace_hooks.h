@@ -0,0 +1,64 @@
+#pragma once
+
+/*
+ * FreeRTOS trace macro hooks for sched_trace.
+ *
+ * Force-included into every translation unit by project_include.cmake, so it must
+ * not pull in any FreeRTOS header. The macros only expand inside tasks.c and
+ * queue.c, where TCB_t and Queue_t are complete types.
+ */
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    SCHED_EV_TASK_IN = 1,        // obj = task now running on this core
+    SCHED_EV_TASK_OUT,           // obj = task leaving this core
+    SCHED_EV_TASK_CREATE,        // obj = new task
+    SCHED_EV_TASK_DELETE,
+    SCHED_EV_QUEUE_SEND,         // obj = queue, arg = 1 from an ISR
+    SCHED_EV_QUEUE_RECEIVE,
+    SCHED_EV_QUEUE_BLOCK_SEND,   // queue full, caller is about to block
+    SCHED_EV_QUEUE_BLOCK_RECEIVE,
+    SCHED_EV_SEM_GIVE,           // queues with item size 0: semaphores and mutexes
+    SCHED_EV_SEM_TAKE,
+    SCHED_EV_SEM_BLOCK_TAKE,
+    SCHED_EV_ISR_ENTER,          // arg = ISR id chosen by the caller
+    SCHED_EV_ISR_EXIT,
+    SCHED_EV_MARK,               // arg = user value
+} sched_trace_event_t;
+
+void sched_trace_record(uint8_t type, const void *obj, uint16_t arg);
+void sched_trace_task_created(const void *task, const char *name);
+void sched_trace_task_switched(uint8_t type);
+
+#define SCHED_TRACE_QUEUE_EVENT(q, queue_ev, sem_ev, isr) \
+    sched_trace_record((q)->uxItemSize ? (queue_ev) : (sem_ev), (q), (isr))
+
+#define traceTASK_SWITCHED_IN()                  sched_trace_task_switched(SCHED_EV_TASK_IN)
+#define traceTASK_SWITCHED_OUT()                 sched_trace_task_switched(SCHED_EV_TASK_OUT)
+#define traceTASK_CREATE(pxNewTCB)               sched_trace_task_created((pxNewTCB), (pxNewTCB)->pcTaskName)
+#define traceTASK_DELETE(pxTaskToDelete)         sched_trace_record(SCHED_EV_TASK_DELETE, (pxTaskToDelete), 0)
+
+#define traceQUEUE_SEND(pxQueue)                 SCHED_TRACE_QUEUE_EVENT(pxQueue, SCHED_EV_QUEUE_SEND, SCHED_EV_SEM_GIVE, 0)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)        SCHED_TRACE_QUEUE_EVENT(pxQueue, SCHED_EV_QUEUE_SEND, SCHED_EV_SEM_GIVE, 1)
+#define traceQUEUE_RECEIVE(pxQueue)              SCHED_TRACE_QUEUE_EVENT(pxQueue, SCHED_EV_QUEUE_RECEIVE, SCHED_EV_SEM_TAKE, 0)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)     SCHED_TRACE_QUEUE_EVENT(pxQueue, SCHED_EV_QUEUE_RECEIVE, SCHED_EV_SEM_TAKE, 1)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)     sched_trace_record(SCHED_EV_QUEUE_BLOCK_SEND, (pxQueue), 0)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)  SCHED_TRACE_QUEUE_EVENT(pxQueue, SCHED_EV_QUEUE_BLOCK_RECEIVE, SCHED_EV_SEM_BLOCK_TAKE, 0)
+
+// Only ports that call these get ISR slices automatically; lab ISRs can use sched_trace_isr_enter/exit()
+#define traceISR_ENTER(n)                        sched_trace_record(SCHED_EV_ISR_ENTER, 0, (n))
+#define traceISR_EXIT()                          sched_trace_record(SCHED_EV_ISR_EXIT, 0, 0)
+#define traceISR_EXIT_TO_SCHEDULER()             sched_trace_record(SCHED_EV_ISR_EXIT, 0, 0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __ASSEMBLER__
@@ -0,0 +1,4 @@
+# The kernel's trace macros must be defined before FreeRTOS.h supplies its empty defaults,
+# so the hook header is force-included into every component, freertos included.
+# project_include.cmake runs before any component is configured, which makes that possible.
+idf_build_set_property(COMPILE_OPTIONS "-include${CMAKE_CURRENT_LIST_DIR}/include/sched_trace_hooks.h" APPEND)
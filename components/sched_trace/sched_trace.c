@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "sched_trace.h"
+
+_Static_assert((SCHED_TRACE_EVENTS & (SCHED_TRACE_EVENTS - 1)) == 0, "SCHED_TRACE_EVENTS must be a power of two");
+_Static_assert(sizeof(sched_trace_entry_t) == 12, "decoder expects 12-byte events");
+
+#if !defined(portNUM_PROCESSORS)
+#define portNUM_PROCESSORS 1
+#endif
+
+#define NAME_LEN 16
+#define CALIBRATION_EVENTS 1024
+#define EVENTS_PER_LINE 8
+
+static sched_trace_entry_t ring[SCHED_TRACE_EVENTS];
+static uint32_t head;                  // total events written since the last start/dump
+static volatile bool enabled;
+static uint32_t event_ns;
+
+// Filled from traceTASK_CREATE even while recording is off, so tasks created at boot have names
+static struct {
+    uint32_t obj;
+    char name[NAME_LEN];
+} names[SCHED_TRACE_MAX_NAMES];
+static uint32_t name_next;
+
+static inline void IRAM_ATTR write_event(uint8_t type, const void *obj, uint16_t arg) {
+    uint32_t i = __atomic_fetch_add(&head, 1, __ATOMIC_RELAXED);
+    sched_trace_entry_t *e = &ring[i & (SCHED_TRACE_EVENTS - 1)];
+    e->timestamp_us = (uint32_t)esp_timer_get_time();
+    e->obj = (uint32_t)(uintptr_t)obj;
+    e->type = type;
+    e->core = (uint8_t)esp_cpu_get_core_id();
+    e->arg = arg;
+}
+
+void IRAM_ATTR sched_trace_record(uint8_t type, const void *obj, uint16_t arg) {
+    if (enabled) write_event(type, obj, arg);
+}
+
+void IRAM_ATTR sched_trace_task_switched(uint8_t type) {
+    if (enabled) write_event(type, xTaskGetCurrentTaskHandle(), 0);
+}
+
+void sched_trace_name(const void *obj, const char *name) {
+    uint32_t key = (uint32_t)(uintptr_t)obj;
+    uint32_t slot = SCHED_TRACE_MAX_NAMES;
+    for (uint32_t i = 0; i < SCHED_TRACE_MAX_NAMES; i++) {
+        if (names[i].obj == key) { slot = i; break; }   // handle reused after a delete
+    }
+    if (slot == SCHED_TRACE_MAX_NAMES) slot = __atomic_fetch_add(&name_next, 1, __ATOMIC_RELAXED) % SCHED_TRACE_MAX_NAMES;
+    strncpy(names[slot].name, name ? name : "?", NAME_LEN - 1);
+    names[slot].name[NAME_LEN - 1] = '\0';
+    names[slot].obj = key;
+}
+
+void sched_trace_task_created(const void *task, const char *name) {
+    sched_trace_name(task, name);
+    sched_trace_record(SCHED_EV_TASK_CREATE, task, 0);
+}
+
+void sched_trace_start(void) {
+    enabled = false;
+    if (event_ns == 0) {
+        // Same write path the hooks use; the calibration events are discarded below
+        int64_t start_us = esp_timer_get_time();
+        for (int i = 0; i < CALIBRATION_EVENTS; i++) write_event(SCHED_EV_MARK, 0, (uint16_t)i);
+        int64_t elapsed_us = esp_timer_get_time() - start_us;
+        event_ns = (uint32_t)(elapsed_us * 1000 / CALIBRATION_EVENTS);
+        if (event_ns == 0) event_ns = 1;
+    }
+    __atomic_store_n(&head, 0, __ATOMIC_RELAXED);
+    enabled = true;
+}
+
+void sched_trace_stop(void) {
+    enabled = false;
+}
+
+bool sched_trace_running(void) {
+    return enabled;
+}
+
+uint32_t sched_trace_recorded(void) {
+    return __atomic_load_n(&head, __ATOMIC_RELAXED);
+}
+
+uint32_t sched_trace_overwritten(void) {
+    uint32_t n = sched_trace_recorded();
+    return n > SCHED_TRACE_EVENTS ? n - SCHED_TRACE_EVENTS : 0;
+}
+
+uint32_t sched_trace_event_ns(void) {
+    return event_ns;
+}
+
+void sched_trace_dump(void) {
+    bool was_enabled = enabled;
+    enabled = false;
+    vTaskDelay(1);   // let a writer on the other core finish its event
+
+    uint32_t end = sched_trace_recorded();
+    uint32_t count = end < SCHED_TRACE_EVENTS ? end : SCHED_TRACE_EVENTS;
+    printf("#SCHED_TRACE v1 events=%lu overwritten=%lu cores=%d event_ns=%lu\n", (unsigned long)count,
+           (unsigned long)sched_trace_overwritten(), portNUM_PROCESSORS, (unsigned long)event_ns);
+    for (uint32_t i = 0; i < SCHED_TRACE_MAX_NAMES; i++) {
+        if (names[i].obj) printf("#N %08lx %s\n", (unsigned long)names[i].obj, names[i].name);
+    }
+    // Oldest first; each line carries up to EVENTS_PER_LINE raw little-endian entries
+    for (uint32_t i = 0; i < count; i += EVENTS_PER_LINE) {
+        printf("#E ");
+        for (uint32_t j = i; j < count && j < i + EVENTS_PER_LINE; j++) {
+            const uint8_t *b = (const uint8_t *)&ring[(end - count + j) & (SCHED_TRACE_EVENTS - 1)];
+            for (size_t k = 0; k < sizeof(sched_trace_entry_t); k++) printf("%02x", b[k]);
+        }
+        printf("\n");
+    }
+    printf("#SCHED_TRACE END\n");
+    fflush(stdout);
+
+    __atomic_store_n(&head, 0, __ATOMIC_RELAXED);
+    enabled = was_enabled;
+}
+
+void sched_trace_poll_console(void) {
+    static bool nonblocking;
+    if (!nonblocking) {
+        int flags = fcntl(fileno(stdin), F_GETFL, 0);
+        if (flags >= 0) fcntl(fileno(stdin), F_SETFL, flags | O_NONBLOCK);
+        nonblocking = true;
+    }
+    int c;
+    bool dump = false;
+    while ((c = getchar()) != EOF) {
+        if (c == 'd' || c == 'D') dump = true;
+    }
+    clearerr(stdin);   // EOF/EAGAIN are sticky otherwise
+    if (dump) sched_trace_dump();
+}
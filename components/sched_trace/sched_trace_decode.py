@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""Chrome/Perfetto JSON timeline from a sched_trace dump.
+
+Reads a captured monitor log (idf.py monitor | tee monitor.log), takes the
+last "#SCHED_TRACE" block (or --dump N) and writes a trace that opens in
+ui.perfetto.dev or chrome://tracing: one track per core with the running
+task, one ISR track per core, and one track per queue/semaphore with its
+send/receive/give/take/block events.
+
+    python3 sched_trace_decode.py monitor.log -o trace.json
+"""
+import argparse
+import collections
+import json
+import struct
+import sys
+
+ENTRY = struct.Struct("<IIBBH")   # sched_trace_entry_t, packed little-endian
+
+EVENTS = {
+    1: "task_in", 2: "task_out", 3: "task_create", 4: "task_delete",
+    5: "queue_send", 6: "queue_receive", 7: "queue_block_send", 8: "queue_block_receive",
+    9: "sem_give", 10: "sem_take", 11: "sem_block_take",
+    12: "isr_enter", 13: "isr_exit", 14: "mark",
+}
+OBJECT_EVENTS = {5, 6, 7, 8, 9, 10, 11}
+
+CORES_PID, OBJECTS_PID = 1, 2
+ISR_TID_BASE = 100
+
+
+def read_dumps(path):
+    """Returns every dump in the log as (header fields, names, raw event bytes)."""
+    dumps, current = [], None
+    with open(path, errors="replace") as f:
+        for line in f:
+            pos = line.find("#")
+            if pos < 0:
+                continue
+            line = line[pos:].strip()
+            if line.startswith("#SCHED_TRACE END"):
+                if current:
+                    dumps.append(current)
+                current = None
+            elif line.startswith("#SCHED_TRACE"):
+                header = dict(field.split("=", 1) for field in line.split()[2:] if "=" in field)
+                current = (header, {}, bytearray())
+            elif current and line.startswith("#N "):
+                _, obj, *name = line.split(" ", 2)
+                current[1][int(obj, 16)] = name[0] if name else obj
+            elif current and line.startswith("#E "):
+                current[2].extend(bytes.fromhex(line[3:].strip()))
+    return dumps
+
+
+def unwrap(entries):
+    """32-bit microsecond timestamps -> monotonic values relative to the first event.
+
+    Cores write concurrently, so neighbours may be a few microseconds out of order;
+    only steps larger than half the range are treated as a wrap.
+    """
+    out, base, prev, offset = [], None, None, 0
+    for ts, obj, kind, core, arg in entries:
+        if prev is not None:
+            delta = (ts - prev) & 0xFFFFFFFF
+            if delta >= 0x80000000:
+                delta -= 1 << 32
+            offset += delta
+        else:
+            base = ts
+        prev = ts
+        out.append((offset, obj, kind, core, arg))
+    return out, base
+
+
+def build_trace(header, names, raw):
+    entries = [ENTRY.unpack_from(raw, i) for i in range(0, len(raw) - ENTRY.size + 1, ENTRY.size)]
+    events, _ = unwrap(entries)
+    name_of = lambda obj: names.get(obj, f"0x{obj:08x}")
+    out = []
+    running = {}                      # core -> (task, start)
+    isr_stack = collections.defaultdict(list)
+    busy = collections.Counter()      # task -> us on a core
+    counts = collections.Counter()
+    object_tids = {}
+    end = events[-1][0] if events else 0
+
+    def slice_(pid, tid, name, start, stop, args=None):
+        out.append({"ph": "X", "pid": pid, "tid": tid, "name": name, "ts": start,
+                    "dur": max(stop - start, 0), "args": args or {}})
+
+    def instant(pid, tid, name, ts, args=None):
+        out.append({"ph": "i", "s": "t", "pid": pid, "tid": tid, "name": name, "ts": ts, "args": args or {}})
+
+    for ts, obj, kind, core, arg in events:
+        kind_name = EVENTS.get(kind, f"event{kind}")
+        counts[kind_name] += 1
+        if kind == 1:
+            running[core] = (obj, ts)
+        elif kind == 2:
+            task, start = running.pop(core, (obj, 0))   # trace began mid-slice
+            slice_(CORES_PID, core, name_of(task), start, ts)
+            busy[name_of(task)] += ts - start
+        elif kind in (3, 4):
+            instant(CORES_PID, core, f"{kind_name} {name_of(obj)}", ts)
+        elif kind in OBJECT_EVENTS:
+            tid = object_tids.setdefault(obj, len(object_tids) + 1)
+            current = running.get(core)
+            args = {"task": "ISR" if arg else (name_of(current[0]) if current else "?"), "core": core}
+            instant(OBJECTS_PID, tid, kind_name, ts, args)
+        elif kind == 12:
+            isr_stack[core].append((arg, ts))
+        elif kind == 13:
+            if isr_stack[core]:
+                isr, start = isr_stack[core].pop()
+                slice_(CORES_PID, ISR_TID_BASE + core, f"ISR {isr}", start, ts)
+        elif kind == 14:
+            instant(CORES_PID, core, f"mark {arg}", ts)
+
+    for core, (task, start) in running.items():
+        slice_(CORES_PID, core, name_of(task), start, end)
+        busy[name_of(task)] += end - start
+
+    meta = [{"ph": "M", "pid": CORES_PID, "name": "process_name", "args": {"name": "Cores"}},
+            {"ph": "M", "pid": OBJECTS_PID, "name": "process_name", "args": {"name": "Queues & semaphores"}}]
+    for core in range(int(header.get("cores", 1))):
+        meta.append({"ph": "M", "pid": CORES_PID, "tid": core, "name": "thread_name", "args": {"name": f"Core {core}"}})
+        meta.append({"ph": "M", "pid": CORES_PID, "tid": ISR_TID_BASE + core, "name": "thread_name",
+                     "args": {"name": f"ISR core {core}"}})
+    for obj, tid in object_tids.items():
+        meta.append({"ph": "M", "pid": OBJECTS_PID, "tid": tid, "name": "thread_name", "args": {"name": name_of(obj)}})
+    return meta + out, busy, counts, end
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("log", help="captured monitor output containing a #SCHED_TRACE dump")
+    ap.add_argument("-o", "--output", default="trace.json")
+    ap.add_argument("--dump", type=int, default=-1, help="which dump in the log (default: last)")
+    args = ap.parse_args()
+
+    dumps = read_dumps(args.log)
+    if not dumps:
+        sys.exit("no complete #SCHED_TRACE dump found")
+    header, names, raw = dumps[args.dump]
+    trace, busy, counts, span = build_trace(header, names, raw)
+    with open(args.output, "w") as f:
+        json.dump({"traceEvents": trace, "displayTimeUnit": "ms"}, f)
+
+    print(f"{len(raw) // ENTRY.size} events over {span / 1000:.1f} ms "
+          f"(overwritten {header.get('overwritten', '?')}, {header.get('event_ns', '?')} ns/event) -> {args.output}")
+    cores = int(header.get("cores", 1))
+    for task, us in busy.most_common():
+        print(f"  {task:<16} {us / 1000:9.1f} ms  {100.0 * us / (span * cores) if span else 0:5.1f}%")
+    print("  " + ", ".join(f"{k}={v}" for k, v in sorted(counts.items())))
+
+
+if __name__ == "__main__":
+    main()
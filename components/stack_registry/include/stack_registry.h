@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Stack registry: every task is registered automatically at creation (the
+ * component links with --wrap around xTaskCreatePinnedToCore /
+ * xTaskCreateStaticPinnedToCore / vTaskDelete), so monitors no longer need a
+ * hand-maintained list of handles, and the configured depth is known.
+ *
+ * uxTaskGetStackHighWaterMark() scans the unused part of a stack, so its cost
+ * grows with the stack size. stack_registry_sample() visits tasks round-robin
+ * and stops once budget_us is spent; the next call carries on where it stopped.
+ *
+ * Each task keeps its lowest free-stack value and a short history of it, from
+ * which the report derives a usage trend and a recommended depth:
+ * used * (100 + STACK_REG_MARGIN_PCT)% + STACK_REG_MARGIN_BYTES, rounded up to
+ * STACK_REG_ROUND_BYTES.
+ */
+
+#define STACK_REG_MAX_TASKS       32
+#define STACK_REG_TREND_SAMPLES   8
+#define STACK_REG_TREND_PERIOD_MS 10000   // spacing of the trend history
+#define STACK_REG_MARGIN_PCT      25
+#define STACK_REG_MARGIN_BYTES    256
+#define STACK_REG_ROUND_BYTES     256
+
+typedef struct {
+    char name[configMAX_TASK_NAME_LEN];   // copied, so a row never mixes two tasks
+    uint32_t depth_bytes;        // as created
+    uint32_t min_free_bytes;     // lowest high-water mark seen
+    uint32_t used_bytes;         // depth - min free
+    uint32_t recommended_bytes;
+    int32_t trend_bytes_per_min; // > 0: usage still growing
+    uint32_t samples;
+    bool alive;
+} stack_reg_report_t;
+
+// Registers a task created some other way (the wrappers call this for everything else)
+void stack_registry_add(TaskHandle_t task, const char *name, uint32_t depth_bytes);
+
+// Samples high-water marks for up to budget_us microseconds; returns the number of tasks sampled
+uint32_t stack_registry_sample(uint32_t budget_us);
+
+// Reports are copied under the registry lock, consistent even while a slot is being reused
+int stack_registry_count(void);
+bool stack_registry_get(int index, stack_reg_report_t *out);
+
+// Logs the table: depth, min free, used, trend and recommended depth per task
+void stack_registry_print(const char *tag);
+
+#ifdef __cplusplus
+}
+#endif
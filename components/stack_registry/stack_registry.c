@@ -0,0 +1,229 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "stack_registry.h"
+
+typedef struct {
+    int64_t time_us;
+    uint32_t min_free_bytes;
+} trend_point_t;
+
+typedef struct {
+    TaskHandle_t handle;
+    char name[configMAX_TASK_NAME_LEN];
+    uint32_t depth_bytes;
+    uint32_t min_free_bytes;
+    uint32_t samples;
+    bool alive;
+    volatile bool scanning;     // stack being read outside the lock; vTaskDelete() waits for it
+    uint8_t trend_head, trend_count;
+    trend_point_t trend[STACK_REG_TREND_SAMPLES];
+} stack_entry_t;
+
+static stack_entry_t entries[STACK_REG_MAX_TASKS];
+static int entry_count = 0;
+static int sample_cursor = 0;
+static int creating = 0;     // creations not yet registered, see __wrap_vTaskDelete()
+static portMUX_TYPE registry_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static stack_entry_t *find_entry(TaskHandle_t task) {
+    for (int i = 0; i < entry_count; i++) {
+        if (entries[i].handle == task) return &entries[i];
+    }
+    return NULL;
+}
+
+void stack_registry_add(TaskHandle_t task, const char *name, uint32_t depth_bytes) {
+    if (!task) return;
+    taskENTER_CRITICAL(&registry_mux);
+    stack_entry_t *e = find_entry(task);   // registered twice
+    // Reuse the slot of a deleted task before growing the table
+    for (int i = 0; !e && i < entry_count; i++) {
+        if (!entries[i].alive && !entries[i].scanning) e = &entries[i];
+    }
+    if (!e && entry_count < STACK_REG_MAX_TASKS) e = &entries[entry_count++];
+    if (e) {
+        memset(e, 0, sizeof(*e));
+        e->handle = task;
+        strncpy(e->name, name ? name : "?", sizeof(e->name) - 1);
+        e->depth_bytes = depth_bytes;
+        e->min_free_bytes = depth_bytes;
+        e->alive = true;
+    }
+    taskEXIT_CRITICAL(&registry_mux);
+}
+
+// --- Link-time wrappers (see CMakeLists.txt) ---
+
+BaseType_t __real_xTaskCreatePinnedToCore(TaskFunction_t code, const char *name, const uint32_t depth,
+                                          void *params, UBaseType_t priority, TaskHandle_t *created, const BaseType_t core);
+TaskHandle_t __real_xTaskCreateStaticPinnedToCore(TaskFunction_t code, const char *name, const uint32_t depth,
+                                                  void *params, UBaseType_t priority, StackType_t *stack,
+                                                  StaticTask_t *tcb, const BaseType_t core);
+void __real_vTaskDelete(TaskHandle_t task);
+
+static void creation_begin(void) {
+    taskENTER_CRITICAL(&registry_mux);
+    creating++;
+    taskEXIT_CRITICAL(&registry_mux);
+}
+
+static void creation_end(void) {
+    taskENTER_CRITICAL(&registry_mux);
+    creating--;
+    taskEXIT_CRITICAL(&registry_mux);
+}
+
+BaseType_t __wrap_xTaskCreatePinnedToCore(TaskFunction_t code, const char *name, const uint32_t depth,
+                                          void *params, UBaseType_t priority, TaskHandle_t *created, const BaseType_t core) {
+    TaskHandle_t handle = NULL;
+    // The task may already run on the other core or at a higher priority before add();
+    // while creating > 0 a vTaskDelete() of it waits for the registration
+    creation_begin();
+    BaseType_t ret = __real_xTaskCreatePinnedToCore(code, name, depth, params, priority, &handle, core);
+    if (ret == pdPASS) stack_registry_add(handle, name, (uint32_t)depth * sizeof(StackType_t));
+    creation_end();
+    if (created) *created = handle;
+    return ret;
+}
+
+TaskHandle_t __wrap_xTaskCreateStaticPinnedToCore(TaskFunction_t code, const char *name, const uint32_t depth,
+                                                  void *params, UBaseType_t priority, StackType_t *stack,
+                                                  StaticTask_t *tcb, const BaseType_t core) {
+    creation_begin();
+    TaskHandle_t handle = __real_xTaskCreateStaticPinnedToCore(code, name, depth, params, priority, stack, tcb, core);
+    stack_registry_add(handle, name, (uint32_t)depth * sizeof(StackType_t));
+    creation_end();
+    return handle;
+}
+
+void __wrap_vTaskDelete(TaskHandle_t task) {
+    TaskHandle_t target = task ? task : xTaskGetCurrentTaskHandle();
+    bool can_wait = xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+    stack_entry_t *e;
+
+    // An unknown handle may belong to a task whose creator hasn't registered it yet:
+    // wait for pending creations, or add() would register the freed handle afterwards
+    while (1) {
+        taskENTER_CRITICAL(&registry_mux);
+        e = find_entry(target);
+        if (e) {
+            e->alive = false;
+            e->handle = NULL;
+        }
+        bool pending = !e && creating > 0;
+        taskEXIT_CRITICAL(&registry_mux);
+        if (!pending || !can_wait) break;
+        vTaskDelay(1);
+    }
+    // Don't free a stack that stack_registry_sample() is reading
+    while (e && e->scanning && can_wait) {
+        vTaskDelay(1);
+    }
+    __real_vTaskDelete(task);
+}
+
+// --- Sampling ---
+
+static void record_trend(stack_entry_t *e, int64_t now_us) {
+    if (e->trend_count) {
+        int last = (e->trend_head + STACK_REG_TREND_SAMPLES - 1) % STACK_REG_TREND_SAMPLES;
+        if (now_us - e->trend[last].time_us < (int64_t)STACK_REG_TREND_PERIOD_MS * 1000) return;
+    }
+    e->trend[e->trend_head] = (trend_point_t){ now_us, e->min_free_bytes };
+    e->trend_head = (e->trend_head + 1) % STACK_REG_TREND_SAMPLES;
+    if (e->trend_count < STACK_REG_TREND_SAMPLES) e->trend_count++;
+}
+
+uint32_t stack_registry_sample(uint32_t budget_us) {
+    int64_t start_us = esp_timer_get_time();
+    uint32_t sampled = 0;
+    for (int visited = 0; visited < entry_count; visited++) {
+        if (sampled && esp_timer_get_time() - start_us >= budget_us) break;
+        stack_entry_t *e = &entries[sample_cursor];
+        sample_cursor = (sample_cursor + 1) % entry_count;
+
+        taskENTER_CRITICAL(&registry_mux);
+        TaskHandle_t handle = e->alive ? e->handle : NULL;
+        if (handle) e->scanning = true;
+        taskEXIT_CRITICAL(&registry_mux);
+        if (!handle) continue;
+
+        // The scan runs with interrupts enabled; the scanning flag keeps the task from being freed
+        uint32_t free_bytes = uxTaskGetStackHighWaterMark(handle) * sizeof(StackType_t);
+
+        int64_t now_us = esp_timer_get_time();
+        taskENTER_CRITICAL(&registry_mux);
+        if (free_bytes < e->min_free_bytes) e->min_free_bytes = free_bytes;
+        e->samples++;
+        e->scanning = false;
+        if (e->alive) record_trend(e, now_us);
+        taskEXIT_CRITICAL(&registry_mux);
+        sampled++;
+    }
+    return sampled;
+}
+
+// --- Reporting ---
+
+int stack_registry_count(void) {
+    taskENTER_CRITICAL(&registry_mux);
+    int count = entry_count;
+    taskEXIT_CRITICAL(&registry_mux);
+    return count;
+}
+
+static uint32_t recommend(uint32_t used_bytes) {
+    uint32_t wanted = used_bytes * (100 + STACK_REG_MARGIN_PCT) / 100 + STACK_REG_MARGIN_BYTES;
+    return (wanted + STACK_REG_ROUND_BYTES - 1) / STACK_REG_ROUND_BYTES * STACK_REG_ROUND_BYTES;
+}
+
+bool stack_registry_get(int index, stack_reg_report_t *out) {
+    // Snapshot the slot: add() may reuse it for a new task while the report is built
+    stack_entry_t snapshot;
+    taskENTER_CRITICAL(&registry_mux);
+    bool valid = index >= 0 && index < entry_count;
+    if (valid) snapshot = entries[index];
+    taskEXIT_CRITICAL(&registry_mux);
+    if (!valid) return false;
+
+    const stack_entry_t *e = &snapshot;
+    memcpy(out->name, e->name, sizeof(out->name));
+    out->depth_bytes = e->depth_bytes;
+    out->min_free_bytes = e->min_free_bytes;
+    out->used_bytes = e->depth_bytes - e->min_free_bytes;
+    out->recommended_bytes = recommend(out->used_bytes);
+    out->samples = e->samples;
+    out->alive = e->alive;
+    out->trend_bytes_per_min = 0;
+    if (e->trend_count >= 2) {
+        int oldest = (e->trend_head + STACK_REG_TREND_SAMPLES - e->trend_count) % STACK_REG_TREND_SAMPLES;
+        int newest = (e->trend_head + STACK_REG_TREND_SAMPLES - 1) % STACK_REG_TREND_SAMPLES;
+        int64_t span_us = e->trend[newest].time_us - e->trend[oldest].time_us;
+        int64_t consumed = (int64_t)e->trend[oldest].min_free_bytes - e->trend[newest].min_free_bytes;
+        if (span_us > 0) out->trend_bytes_per_min = (int32_t)(consumed * 60000000 / span_us);
+    }
+    return true;
+}
+
+void stack_registry_print(const char *tag) {
+    uint32_t total_depth = 0, total_recommended = 0;
+    ESP_LOGI(tag, "%-16s %6s %6s %6s %7s %6s  %s", "Task", "Depth", "MinFr", "Used", "B/min", "Rec", "Advice");
+    int count = stack_registry_count();
+    for (int i = 0; i < count; i++) {
+        stack_reg_report_t r;
+        if (!stack_registry_get(i, &r) || !r.alive || r.samples == 0) continue;
+        total_depth += r.depth_bytes;
+        total_recommended += r.recommended_bytes;
+        const char *advice = r.recommended_bytes > r.depth_bytes ? "GROW" :
+                             r.recommended_bytes < r.depth_bytes ? "shrink" : "ok";
+        // A still-growing stack hasn't shown its peak yet
+        if (r.trend_bytes_per_min > 0) advice = "growing, wait";
+        ESP_LOGI(tag, "%-16s %6lu %6lu %6lu %7ld %6lu  %s", r.name, (unsigned long)r.depth_bytes,
+                 (unsigned long)r.min_free_bytes, (unsigned long)r.used_bytes, (long)r.trend_bytes_per_min,
+                 (unsigned long)r.recommended_bytes, advice);
+    }
+    ESP_LOGI(tag, "Total stack %lu B, recommended %lu B", (unsigned long)total_depth, (unsigned long)total_recommended);
+}